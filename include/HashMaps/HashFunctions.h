@@ -5,9 +5,18 @@
 #ifndef HASHFUNCTIONS_H
 #define HASHFUNCTIONS_H
 
+#include <algorithm>
 #include <random>
 #include <chrono>
 #include <cinttypes>
+#include <cmath>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 static constexpr size_t SIZE_ONE = 1;
 static constexpr size_t SIZE_ZERO = 0;
@@ -26,11 +35,11 @@ static constexpr size_t primePer2Power[] = {
     SIZE_ZERO-59, // 2^48-2^56
 };
 
-inline int extractMSB(const size_t x)
+constexpr int extractMSB(const size_t x)
     // IMPORTANT: x cannot be 0, it means undefined behavior
 {
-    static constexpr int maxB = sizeof(size_t) * 8 - 1;
-    static constexpr size_t start = SIZE_ONE << maxB;
+    constexpr int maxB = sizeof(size_t) * 8 - 1;
+    constexpr size_t start = SIZE_ONE << maxB;
 
     int bit = maxB;
     size_t iter = start;
@@ -43,6 +52,57 @@ inline int extractMSB(const size_t x)
     return bit;
 }
 
+constexpr size_t ceilPow2(const size_t x)
+    // Returns the smallest power of 2 not lower than x, for x <= 1 returns 1
+{
+    if (x <= 1) return 1;
+    return POW2FAST(extractMSB(x - 1) + 1);
+}
+
+// FNV-1a hash of the bytes, usable as HashableAccessor for string keys also in constant expressions
+constexpr size_t fnv1aHash(const std::string_view str) {
+    constexpr uint64_t fnvOffset = 0xcbf29ce484222325;
+    constexpr uint64_t fnvPrime = 0x100000001b3;
+
+    uint64_t hash = fnvOffset;
+    for (const char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= fnvPrime;
+    }
+
+    return hash;
+}
+
+// Murmur3 64-bit finalizer - bijection spreading entropy of the input over all 64 bits
+constexpr uint64_t mixHash64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    x ^= x >> 33;
+    return x;
+}
+
+// Mask used by multiply-shift formula below for table of given size, IMPORTANT size < 2^32
+constexpr uint64_t multiplyShiftMask(const uint64_t size) {
+    return (size << 32) - 1;
+}
+
+// h(x) = ((ax + b) & (2^(32+w)-1) ) >> 32, where mask = 2^(32+w)-1, see Fast2PowHashFunction
+constexpr size_t multiplyShiftHash(const uint64_t a, const uint64_t b, const uint64_t mask, const size_t x) {
+    return ((a*x + b) & mask) >> 32;
+}
+
+// Saves hashes of count keys into out, uses batch operator of the hash function when it has one
+template<class HashFuncT, class KeyT>
+void hashKeysBatch(const HashFuncT& func, const KeyT* keys, const size_t count, size_t* out) {
+    if constexpr (requires { func(keys, count, out); })
+        func(keys, count, out);
+    else
+        for (size_t i = 0; i < count; ++i)
+            out[i] = func(keys[i]);
+}
+
 template<
     class KeyT,
     size_t (*HashableAccessor)(const KeyT& item) = [](const KeyT& item) { return static_cast<size_t>(item); }
@@ -65,7 +125,7 @@ public:
 
     // IMPORTANT size < 2^32
     explicit Fast2PowHashFunction(const uint64_t size):
-        _a(randEngine_64()), _b(randEngine_64()), _mask((size << 32) - 1) {}
+        _a(randEngine_64()), _b(randEngine_64()), _mask(multiplyShiftMask(size)) {}
 
     // ------------------------------
     // Class interaction
@@ -77,18 +137,46 @@ public:
     }
 
     void changeSize(const size_t nSize) {
-        _mask = (nSize << 32) - 1;
+        _mask = multiplyShiftMask(nSize);
     }
 
     size_t operator()(const size_t x) const {
-        return ((_a*x + _b) & _mask) >> 32;
+        return multiplyShiftHash(_a, _b, _mask, x);
+    }
+
+    // Batch version - saves hashes of count keys into out, with AVX2 four keys are hashed by every instruction.
+    // AVX2 has no 64-bit multiplication, so a*x mod 2^64 is built from 32-bit halves:
+    // aLo*xLo + ((aLo*xHi + aHi*xLo) << 32)
+    void operator()(const KeyT* keys, const size_t count, size_t* out) const {
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        if constexpr (std::is_integral_v<KeyT> && sizeof(KeyT) == sizeof(uint64_t)) {
+            const __m256i a = _mm256_set1_epi64x(static_cast<int64_t>(_a));
+            const __m256i aHi = _mm256_set1_epi64x(static_cast<int64_t>(_a >> 32));
+            const __m256i b = _mm256_set1_epi64x(static_cast<int64_t>(_b));
+            const __m256i mask = _mm256_set1_epi64x(static_cast<int64_t>(_mask));
+
+            for (; i + 4 <= count; i += 4) {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(aHi, x), _mm256_mul_epu32(a, _mm256_srli_epi64(x, 32)));
+                const __m256i ax = _mm256_add_epi64(_mm256_mul_epu32(a, x), _mm256_slli_epi64(cross, 32));
+                const __m256i hash = _mm256_srli_epi64(_mm256_and_si256(_mm256_add_epi64(ax, b), mask), 32);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), hash);
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+            out[i] = multiplyShiftHash(_a, _b, _mask, keys[i]);
     }
 
     // ------------------------------
     // Class fields
     // ------------------------------
 private:
-    inline static std::mt19937_64 randEngine_64{
+    inline static thread_local std::mt19937_64 randEngine_64{
         static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count())
     };
 
@@ -150,7 +238,8 @@ public:
 
     void RollParameteres() {
         if constexpr (sizeof(size_t) == 8) {
-            static std::mt19937_64 randEngine_64{
+            // thread_local - hash functions are also created by workers building partitions concurrently
+            thread_local std::mt19937_64 randEngine_64{
                 static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count())
             };
 
@@ -159,7 +248,7 @@ public:
         }
 
         if constexpr (sizeof(size_t) == 4) {
-            static std::mt19937 randEngine_32{
+            thread_local std::mt19937 randEngine_32{
                 static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count())
             };
 
@@ -203,6 +292,180 @@ private:
     size_t _sizeMod;
 };
 
+template<
+    class KeyT,
+    size_t (*HashableAccessor)(const KeyT& item) = [](const KeyT& item) { return static_cast<size_t>(item); }
+>class JumpConsistentHash {
+    /*                  Description
+     *  Jump consistent hash (Lamping, Veach) - maps keys onto shards [0, size), when shard count changes
+     *  from n to n+1 only 1/(n+1) of keys move, all of them to the new shard. Uses no memory and
+     *  works in O(log n) per key.
+     *
+     *  Function is deterministic - it has no random parameters, so every process computes the same placement.
+     *  Only appending or removing the last shard is supported, shards in the middle cannot be removed.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // IMPORTANT size > 0
+    explicit JumpConsistentHash(const size_t size): _size(static_cast<int64_t>(size)) {}
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    void changeSize(const size_t nSize) {
+        _size = static_cast<int64_t>(nSize);
+    }
+
+    size_t operator()(const KeyT& key) const {
+        return _jump(mixHash64(HashableAccessor(key)));
+    }
+
+    // Batch version - saves shards of count keys into out
+    void operator()(const KeyT* keys, const size_t count, size_t* out) const {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = _jump(mixHash64(HashableAccessor(keys[i])));
+    }
+
+    // ------------------------------
+    // Class private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] size_t _jump(uint64_t key) const {
+        int64_t bucket = -1;
+        int64_t next = 0;
+
+        while (next < _size) {
+            bucket = next;
+            key = key * 2862933555777941757ULL + 1;
+            next = static_cast<int64_t>((bucket + 1) * (static_cast<double>(SIZE_ONE << 31) / static_cast<double>((key >> 33) + 1)));
+        }
+
+        return static_cast<size_t>(bucket);
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+
+    int64_t _size;
+};
+
+template<
+    class KeyT,
+    size_t (*HashableAccessor)(const KeyT& item) = [](const KeyT& item) { return static_cast<size_t>(item); }
+>class WeightedRendezvousHash {
+    /*                  Description
+     *  Weighted rendezvous (highest random weight) hashing - every shard gets score of the key:
+     *      score(key, shard) = weight(shard) / -ln(U(key, shard)),     U - uniform hash from (0, 1)
+     *  and key is placed on the shard with the highest score. Key lands on shard with probability
+     *  proportional to its weight. Changing weight of single shard or adding/removing any shard moves
+     *  only keys, which are gained or lost by that shard.
+     *
+     *  Seeds of shards depend only on shard index, so function is deterministic across processes.
+     *  Cost is O(shard count) per key, batch version processes keys in tiles shard by shard,
+     *  so shard table stays in the cache.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // All shards get the same weight, IMPORTANT size > 0
+    explicit WeightedRendezvousHash(const size_t size): WeightedRendezvousHash(std::vector<double>(size, 1.0)) {}
+
+    // IMPORTANT weights have to be positive
+    explicit WeightedRendezvousHash(const std::vector<double>& weights) {
+        for (const double weight : weights) addShard(weight);
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    void addShard(const double weight) {
+        _seeds.push_back(mixHash64(_seeds.size() + ShardSeedOffset));
+        _weights.push_back(weight);
+    }
+
+    void setWeight(const size_t shard, const double weight) {
+        _weights[shard] = weight;
+    }
+
+    // Shards keep their indexes, so removed one gets zero weight and never wins
+    void removeShard(const size_t shard) {
+        _weights[shard] = 0.0;
+    }
+
+    [[nodiscard]] size_t getShardCount() const {
+        return _weights.size();
+    }
+
+    size_t operator()(const KeyT& key) const {
+        const uint64_t keyHash = mixHash64(HashableAccessor(key));
+
+        size_t best{};
+        double bestScore = -1.0;
+        for (size_t shard = 0; shard < _weights.size(); ++shard) {
+            if (const double score = _score(keyHash, shard); score > bestScore) {
+                bestScore = score;
+                best = shard;
+            }
+        }
+
+        return best;
+    }
+
+    // Batch version - saves shards of count keys into out
+    void operator()(const KeyT* keys, const size_t count, size_t* out) const {
+        uint64_t hashes[BatchTile];
+        double bestScores[BatchTile];
+
+        for (size_t tile = 0; tile < count; tile += BatchTile) {
+            const size_t tileSize = std::min(BatchTile, count - tile);
+
+            for (size_t i = 0; i < tileSize; ++i) {
+                hashes[i] = mixHash64(HashableAccessor(keys[tile + i]));
+                bestScores[i] = -1.0;
+            }
+
+            for (size_t shard = 0; shard < _weights.size(); ++shard)
+                for (size_t i = 0; i < tileSize; ++i)
+                    if (const double score = _score(hashes[i], shard); score > bestScores[i]) {
+                        bestScores[i] = score;
+                        out[tile + i] = shard;
+                    }
+        }
+    }
+
+    // ------------------------------
+    // Class private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] double _score(const uint64_t keyHash, const size_t shard) const {
+        // 53 random bits shifted by half of the step, so U is never 0 nor 1
+        const double u = (static_cast<double>(mixHash64(keyHash ^ _seeds[shard]) >> 11) + 0.5) * 0x1.0p-53;
+        return _weights[shard] / -std::log(u);
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t BatchTile = 64;
+    static constexpr uint64_t ShardSeedOffset = 0x9E3779B97F4A7C15;
+private:
+    std::vector<uint64_t> _seeds{};
+    std::vector<double> _weights{};
+};
+
 struct IdentityHash {
     IdentityHash() = default;
     explicit IdentityHash([[maybe_unused]] size_t) {}
@@ -10,12 +10,44 @@
 void PlainMapTest();
 void ExpandiblePlainMapTest();
 void HashRateTest(bool interactive = false);
+void SnapshotLoadTest(bool interactive = false);
+void StaticPerfectMapTest(bool interactive = false);
+void ConstexprPerfectMapTest();
+void HashJoinTest(bool interactive = false);
+void GroupByTest(bool interactive = false);
+void CacheTest(bool interactive = false);
+void SetMemoryTest(bool interactive = false);
+void SpaceSavingTest(bool interactive = false);
+void ShardPlacementTest(bool interactive = false);
+void ParallelRehashTest(bool interactive = false);
+void CowSnapshotTest(bool interactive = false);
+void ValueLogTest(bool interactive = false);
+void CompactDictTest(bool interactive = false);
+void ExtendibleFileMapTest(bool interactive = false);
+void ListCompactionTest(bool interactive = false);
+void StringInternTest(bool interactive = false);
 
 inline int hashMain() {
     std::cout << "Choose type of the structure to be tested:\n"
     << "1) Plain hash map\n"
     << "2) Expandible plain hash map\n"
-    << "3) Comparison of chain hash map with unordered_map\n";
+    << "3) Comparison of chain hash map with unordered_map\n"
+    << "4) Chain hash map snapshot - rebuilding vs mapping comparison\n"
+    << "5) Static minimal perfect hash map - build and access test\n"
+    << "6) Compile-time perfect hash map presentation\n"
+    << "7) Hash join - radix partitioning vs no partitioning comparison\n"
+    << "8) Group-by aggregation - batched aggregates vs operator[] counting\n"
+    << "9) Bounded CLOCK cache under Zipfian trace\n"
+    << "10) Key-only chain set vs chain map memory comparison\n"
+    << "11) Space-Saving heavy hitters on Zipfian stream\n"
+    << "12) Shard placement - jump consistent and rendezvous hashing vs modulo\n"
+    << "13) Parallel rehash of chain hash map - speedup per thread count\n"
+    << "14) Copy-on-write snapshots vs deep copies of chain hash map\n"
+    << "15) Value log map - large items stored out of line vs inline\n"
+    << "16) Insertion ordered compact dict vs chain hash map - memory and iteration\n"
+    << "17) File backed extendible hash map with limited page cache\n"
+    << "18) Linked list bucket compaction after insert/remove churn\n"
+    << "19) String keyed map vs map keyed by interned string handles\n";
 
     int choosenOption{};
     std::cin >> choosenOption;
@@ -30,6 +62,54 @@ inline int hashMain() {
         case 3:
             HashRateTest(true);
             break;
+        case 4:
+            SnapshotLoadTest(true);
+            break;
+        case 5:
+            StaticPerfectMapTest(true);
+            break;
+        case 6:
+            ConstexprPerfectMapTest();
+            break;
+        case 7:
+            HashJoinTest(true);
+            break;
+        case 8:
+            GroupByTest(true);
+            break;
+        case 9:
+            CacheTest(true);
+            break;
+        case 10:
+            SetMemoryTest(true);
+            break;
+        case 11:
+            SpaceSavingTest(true);
+            break;
+        case 12:
+            ShardPlacementTest(true);
+            break;
+        case 13:
+            ParallelRehashTest(true);
+            break;
+        case 14:
+            CowSnapshotTest(true);
+            break;
+        case 15:
+            ValueLogTest(true);
+            break;
+        case 16:
+            CompactDictTest(true);
+            break;
+        case 17:
+            ExtendibleFileMapTest(true);
+            break;
+        case 18:
+            ListCompactionTest(true);
+            break;
+        case 19:
+            StringInternTest(true);
+            break;
         default:
             break;
     }
@@ -6,10 +6,18 @@
 #define CHAINHASHINGMAP_H
 
 #include "plainHashMap.h"
+#include "chainMapSnapshot.h"
 #include "../linkedListHelpers.h"
+#include "../parallelHelpers.h"
 
 #include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <climits>
+#include <cmath>
+#include <memory>
+#include <utility>
 #include <vector>
 
 /*                  IMPORTANT NOTES - BUCKETS:
@@ -20,22 +28,225 @@
  *  - "size_t size() const" method returning number of actually stored elements
  *  - "bool search(const KeyT&) const" method - returning true - element does exists inside the bucket,
  *                                              false - element does not exists
+ *  - "const ItemT* find(const KeyT&) const" and "ItemT* find(const KeyT&)" methods - return pointer to matching element
+ *                                              or nullptr, const version must not modify the bucket at all,
+ *                                              so it can be used concurrently by many readers
+ *  - optional "void prefetch(const KeyT&) const" method - hints the cpu to load memory, which will be touched by find
+ *                                              of the key, used by batched lookups
+ *  - "void forEach(FuncT&&) const" method template - calls func(key, item) for every stored element
+ *  - optional "void compact()" method - releases memory kept for future inserts or lays elements out densely,
+ *                                              used by optimize, compact and compactStep
  *  - "void remove(const KeyT&)" method - perform removing, allowed without any safety checks, can be same as safe remvoe
  *  - "bool safeRemove(const KeyT&)" method - performs removing only if is sure that key exists inside the bucket
  *  - "ItemT& get(const KeyT&)" method - returns matching element. It can assume that element exists.
  *  - "ItemT& safeGet(const KeyT&)" method - returns matching element if exists if not create empty slot under passed keys and returns reference to this slot
- *  - "static std::vector<BucketT>reorganizeBuckets(std::vector<BucketT>, size_t, HashFuncT)" -
+ *  - "static std::vector<BucketT>reorganizeBuckets(std::vector<BucketT>, size_t, HashFuncT, size_t threadCount)" -
  *      reorganizes buckets passed as parameter to a new set of buckets of size passed as an argument
- *      with manner defined by passed hash function. Returns new organized vector
+ *      with manner defined by passed hash function. Returns new organized vector. Up to threadCount threads
+ *      can be used, buckets defined here do it with scatterReorganizeBuckets
  *
  */
 
+/*                  IMPORTANT NOTES - RESIZE POLICIES:
+ *
+ *  All acceptable resize policy classes should have:
+ *  - "static size_t growSize(size_t)" method - returns bucket count used after exceeding max load factor,
+ *  - "static size_t shrinkSize(size_t)" method - returns bucket count used after falling below shrink barrier,
+ *  - "static size_t shrinkBarrier(size_t, float)" method - returns element count, below which map with given bucket count
+ *                                                          and max load factor should be shrunk.
+ *
+ *  Returned sizes have to be powers of 2. Policy should also ensure hysteresis - load factor after any resize
+ *  has to lie strictly between both barriers, otherwise insert/remove sequence around the barrier would
+ *  perform full rehash on every operation.
+ */
+
 /*                  GENRAL TODOS:
  *  - implement other bucket types?
- *  - add automatical celling to power2 size in constructor
  *  - AVX support?
  */
 
+template<
+    size_t GrowthFactor = 2,
+    size_t ShrinkFactor = 2,
+    size_t ShrinkTriggerDivisor = 4
+>struct ChainMapResizePolicy {
+    /*                  Description
+     *  Map grows GrowthFactor times after exceeding max load factor and shrinks ShrinkFactor times,
+     *  when load factor falls below max_load_factor / ShrinkTriggerDivisor. Both factors have to be lower than divisor,
+     *  so the load right after resize never lies on any of the barriers:
+     *      after growth: load = max_load / GrowthFactor > max_load / ShrinkTriggerDivisor
+     *      after shrink: load = max_load * ShrinkFactor / ShrinkTriggerDivisor < max_load
+     */
+
+    static_assert(GrowthFactor > 1 && (GrowthFactor & (GrowthFactor - 1)) == 0, "GrowthFactor has to be power of 2");
+    static_assert(ShrinkFactor > 1 && (ShrinkFactor & (ShrinkFactor - 1)) == 0, "ShrinkFactor has to be power of 2");
+    static_assert(GrowthFactor < ShrinkTriggerDivisor && ShrinkFactor < ShrinkTriggerDivisor,
+        "Resize factors have to be lower than shrink divisor, otherwise there is no hysteresis");
+
+    static constexpr size_t growSize(const size_t size) {
+        return size * GrowthFactor;
+    }
+
+    static constexpr size_t shrinkSize(const size_t size) {
+        return size / ShrinkFactor;
+    }
+
+    static size_t shrinkBarrier(const size_t size, const float maxLoadFactor) {
+        return static_cast<size_t>(size * maxLoadFactor / ShrinkTriggerDivisor);
+    }
+};
+
+template<class ResizePolicyT>
+struct ChainMapSizing {
+    /*                  Description
+     *  Resize bookkeeping shared by chain map variants: barriers derived from max load factor and ResizePolicyT,
+     *  bucket count reserved by the user and number of full rehashes. Maps ask it for the bucket count to resize to
+     *  and only move their elements themselves.
+     */
+
+    // Sets barriers for the bucket count, map does not shrink below reserved size
+    void updateBarriers(const size_t size) {
+        nextUpScaleResize = static_cast<size_t>(size * maxLoadFactor);
+        nextDownScaleResize = size <= minSize ? 0 : ResizePolicyT::shrinkBarrier(size, maxLoadFactor);
+    }
+
+    // Returns the smallest allowed bucket count holding elemCount elements without exceeding max load factor
+    [[nodiscard]] size_t getFittingSize(const size_t elemCount) const {
+        const auto minBuckets = static_cast<size_t>(std::ceil(elemCount / maxLoadFactor));
+        return std::max(InitMapSize, ceilPow2(minBuckets));
+    }
+
+    [[nodiscard]] bool shouldGrow(const size_t elemCount) const {
+        return elemCount > nextUpScaleResize;
+    }
+
+    [[nodiscard]] bool shouldShrink(const size_t elemCount) const {
+        return elemCount < nextDownScaleResize;
+    }
+
+    [[nodiscard]] static size_t getGrowSize(const size_t size) {
+        return ResizePolicyT::growSize(size);
+    }
+
+    // custom policies may shrink by any factor, map still never goes below reserved size
+    [[nodiscard]] size_t getShrinkSize(const size_t size) const {
+        return std::max(minSize, ResizePolicyT::shrinkSize(size));
+    }
+
+    // Reserves bucket count fitting elemCount, returns size map has to be resized to or 0, when actual one is enough
+    [[nodiscard]] size_t reserve(const size_t elemCount, const size_t size) {
+        minSize = getFittingSize(elemCount);
+        if (minSize > size) return minSize;
+
+        updateBarriers(size);
+        return 0;
+    }
+
+    // Drops reservation, returns smaller size fitting elemCount map should be resized to or 0, when there is none
+    [[nodiscard]] size_t dropReservation(const size_t elemCount, const size_t size) {
+        minSize = InitMapSize;
+        if (const size_t nSize = getFittingSize(elemCount); nSize < size) return nSize;
+
+        updateBarriers(size);
+        return 0;
+    }
+
+    // Has to be called before map holding elemCount elements is resized to nSize buckets. Returns false, when there
+    // is nothing to move (e.g. reserve on fresh map) - such resize is not counted as rehash.
+    bool beginResize(const size_t nSize, const size_t elemCount) {
+        updateBarriers(nSize);
+        if (elemCount == 0) return false;
+
+        ++rehashCount;
+        return true;
+    }
+
+    static constexpr double DefaultRehashPolicy = 1.0;
+    static constexpr size_t InitMapSize = 8;
+
+    float maxLoadFactor = DefaultRehashPolicy; // number used to deduce barriers
+    size_t nextUpScaleResize{}; // next barrier, which overloading concludes to full rehash
+    size_t nextDownScaleResize{}; // next barrier, which underloading concludes to full rehash
+    size_t minSize = InitMapSize; // size reserved by the user
+    size_t rehashCount{}; // full rehashes performed since creation of the map
+};
+
+template<class BucketT, class EntryT, class OuterHashFuncT, class VisitT, class PlaceT>
+std::vector<BucketT> scatterReorganizeBuckets(std::vector<BucketT>& oldBuckets, const size_t nSize,
+    const OuterHashFuncT& nFunc, const size_t threadCount, VisitT&& visit, PlaceT&& place)
+{
+    /*                  Description
+     *  Parallel body of reorganizeBuckets shared by all bucket types. Old buckets are split into equal ranges
+     *  (tasks) and new buckets into contiguous blocks:
+     *      1. every task counts its elements falling into every block,
+     *      2. prefix sums of counts, ordered by block then task, give every (block, task) pair private area
+     *         of the staging array, so tasks scatter entries into it without any locks,
+     *      3. every block is filled by single thread, which is the only owner of all its buckets.
+     *
+     *  visit(oldBucket, emit) has to call emit(key, entry) for every element of the old bucket, entry should be
+     *  cheap to copy (pointer to the element), because old buckets stay alive until new ones are filled.
+     *  place(newBucket, entry) inserts the element into the new bucket.
+     */
+
+    static constexpr size_t TasksPerThread = 4;
+
+    struct staged {
+        size_t hash;
+        EntryT entry;
+    };
+
+    const size_t taskCount = threadCount * TasksPerThread;
+    const size_t blockCount = std::min(nSize, taskCount);
+    const size_t blockSize = (nSize + blockCount - 1) / blockCount;
+
+    auto getRange = [&](const size_t task) {
+        return std::make_pair(oldBuckets.size() * task / taskCount, oldBuckets.size() * (task + 1) / taskCount);
+    };
+
+    // offsets[block * taskCount + task] - first staging position of given pair, last one holds element count
+    std::vector<size_t> offsets(blockCount * taskCount + 1);
+    parallelForEachTask(taskCount, threadCount, [&](const size_t task) {
+        std::vector<size_t> counts(blockCount);
+        const auto [begin, end] = getRange(task);
+
+        for (size_t i = begin; i < end; ++i)
+            visit(oldBuckets[i], [&](const auto& key, const EntryT&) { ++counts[nFunc(key) / blockSize]; });
+
+        for (size_t block = 0; block < blockCount; ++block)
+            offsets[block * taskCount + task] = counts[block];
+    });
+
+    size_t sum = 0;
+    for (auto& offset : offsets) {
+        const size_t count = offset;
+        offset = sum;
+        sum += count;
+    }
+
+    const auto staging = std::make_unique_for_overwrite<staged[]>(sum);
+    parallelForEachTask(taskCount, threadCount, [&](const size_t task) {
+        std::vector<size_t> cursors(blockCount);
+        const auto [begin, end] = getRange(task);
+
+        for (size_t block = 0; block < blockCount; ++block)
+            cursors[block] = offsets[block * taskCount + task];
+
+        for (size_t i = begin; i < end; ++i)
+            visit(oldBuckets[i], [&](const auto& key, const EntryT& entry) {
+                const size_t hash = nFunc(key);
+                staging[cursors[hash / blockSize]++] = staged{ hash, entry };
+            });
+    });
+
+    std::vector<BucketT> nBuckets(nSize);
+    parallelForEachTask(blockCount, threadCount, [&](const size_t block) {
+        for (size_t i = offsets[block * taskCount]; i < offsets[(block + 1) * taskCount]; ++i)
+            place(nBuckets[staging[i].hash], staging[i].entry);
+    });
+
+    return nBuckets;
+}
+
 template <
     class KeyT,
     class ItemT,
@@ -46,6 +257,7 @@ template <
     // Class creation
     // ------------------------------
 public:
+    using InnerHashFuncT = HashFuncT;
 
     PlainHashBucketT(): _map(DefaultBucketSize) {};
 
@@ -72,7 +284,42 @@ public:
     }
 
     [[nodiscard]] bool search(const KeyT& key) const {
-        return _map.searchAndSave(key) && _comp(_map.getLastSearchedKey(), key);
+        return find(key) != nullptr;
+    }
+
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        const auto& [ keys, items, occup ] = _map.getUnderlyingArrays();
+        const size_t hash = _map.getHashFunc()(key);
+
+        return occup[hash] && _comp(keys[hash], key) ? &items[hash] : nullptr;
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        return const_cast<ItemT*>(std::as_const(*this).find(key));
+    }
+
+    void prefetch(const KeyT& key) const {
+        const auto& [ keys, items, occup ] = _map.getUnderlyingArrays();
+        const size_t hash = _map.getHashFunc()(key);
+
+        __builtin_prefetch(keys.data() + hash);
+        if constexpr (!std::is_empty_v<ItemT>) __builtin_prefetch(items.data() + hash);
+    }
+
+    template<class FuncT>
+    void forEach(FuncT&& func) const {
+        const auto& [ keys, items, occup ] = _map.getUnderlyingArrays();
+        occup.forEachSet([&](const size_t pos) { func(keys[pos], items[pos]); });
+    }
+
+    // Shrinks perfect hashing table to the smallest power of 2 size (doubling from element count), for which
+    // collision free hash function was found in few tries
+    void compact() {
+        for (size_t nSize = ceilPow2(_elemCount); nSize < _map.getSize(); nSize *= 2)
+            if (_map.resize(nSize, CompactTries)) {
+                _nextResize = static_cast<size_t>(std::sqrt(static_cast<double>(nSize))) + 1;
+                return;
+            }
     }
 
     // NOTE: key must be contained in the bucket
@@ -93,30 +340,71 @@ public:
     }
 
     [[nodiscard]] ItemT& safeGet(const KeyT& key) {
-        if (_map.searchAndSave(key)) return _map.getLastSearched();
+        if (ItemT* item = find(key)) return *item;
 
-        _map.insert(key, ItemT{});
+        _insert(key, ItemT{});
         return _map[key];
     }
 
-    // TODO: Possible boost gained with AVX
+    // Serial path collects occupied slots of consecutive buckets into batches of ReorganizeBatchSize elements,
+    // hashes whole batch at once (vectorized for hash functions with batch operator, see hashKeysBatch),
+    // prefetches all target buckets and only then inserts the elements
     template<class OuterHashFuncT>
-    static std::vector<PlainHashBucketT> reorganizeBuckets(std::vector<PlainHashBucketT> oldBuckets, size_t nSize, OuterHashFuncT nFunc) {
+    static std::vector<PlainHashBucketT> reorganizeBuckets(std::vector<PlainHashBucketT> oldBuckets, size_t nSize,
+        OuterHashFuncT nFunc, const size_t threadCount = 1)
+    {
+        if (threadCount > 1)
+            return scatterReorganizeBuckets<PlainHashBucketT, std::pair<const KeyT*, const ItemT*>>(oldBuckets, nSize, nFunc, threadCount,
+                [](const PlainHashBucketT& bucket, auto&& emit) {
+                    const auto& [ keys, items, occup ] = bucket._map.getUnderlyingArrays();
+                    occup.forEachSet([&](const size_t pos) { emit(keys[pos], std::make_pair(&keys[pos], &items[pos])); });
+                },
+                [](PlainHashBucketT& bucket, const std::pair<const KeyT*, const ItemT*>& entry) {
+                    bucket._insert(*entry.first, *entry.second);
+                });
+
         std::vector<PlainHashBucketT> nBuckets(nSize);
 
+        const KeyT* keys[ReorganizeBatchSize];
+        const ItemT* items[ReorganizeBatchSize];
+        size_t hashes[ReorganizeBatchSize];
+        size_t count = 0;
+
+        auto scatterBatch = [&] {
+            if constexpr (std::is_trivial_v<KeyT>) {
+                KeyT batch[ReorganizeBatchSize];
+                for (size_t i = 0; i < count; ++i) batch[i] = *keys[i];
+                hashKeysBatch(nFunc, batch, count, hashes);
+            }
+            else
+                for (size_t i = 0; i < count; ++i) hashes[i] = nFunc(*keys[i]);
+
+            for (size_t i = 0; i < count; ++i)
+                __builtin_prefetch(nBuckets.data() + hashes[i]);
+
+            for (size_t i = 0; i < count; ++i)
+                nBuckets[hashes[i]]._insert(*keys[i], *items[i]);
+
+            count = 0;
+        };
+
         for (const auto& oBucket : oldBuckets) {
             const auto& [ oKeys, oItems, occup ] = oBucket._map.getUnderlyingArrays();
 
-            for (size_t i = 0; i < occup.size(); ++i)
-                if (occup[i] == true) {
-                    const size_t hash = nFunc(oKeys[i]);
-                    nBuckets[hash]._insert(oKeys[i], oItems[i]);
-                }
+            occup.forEachSet([&](const size_t pos) {
+                keys[count] = &oKeys[pos];
+                items[count] = &oItems[pos];
+                if (++count == ReorganizeBatchSize) scatterBatch();
+            });
         }
+        scatterBatch();
 
         return nBuckets;
     }
 
+    [[nodiscard]] const _baseExpandiblePlainMapT<KeyT, ItemT, HashFuncT>& getUnderlyingMap() const {
+        return _map;
+    }
 
     // ------------------------------
     // Private methods
@@ -124,17 +412,20 @@ public:
 private:
 
     void _insert(const KeyT& key, const ItemT& item) {
-        if (++_elemCount == _nextResize) {
-            _nextResize++;
-            _map.resizeUnconditionally(_map.getSize() * DefaultResizeCoef);
-        }
+        if (++_elemCount >= _nextResize) _grow();
 
         while (!_map.insert(key, item)) {
-            _nextResize++;
-            _map.resizeUnconditionally(_map.getSize() * DefaultResizeCoef);
+            _grow();
         } // also performs rehashing
     }
 
+    // Table of perfect hashing has to stay quadratic in element count, otherwise collisions become certain
+    // and every insert would double the table again
+    void _grow() {
+        _map.resizeUnconditionally(_map.getSize() * DefaultResizeCoef);
+        _nextResize = static_cast<size_t>(std::sqrt(static_cast<double>(_map.getSize()))) + 1;
+    }
+
 
     // ------------------------------
     // class fields
@@ -143,6 +434,8 @@ public:
     static constexpr size_t DefaultBucketSize = 4;
     static constexpr size_t DefaultResizeCoef = 2;
     static constexpr size_t StartResizeTrehsold = 3;
+    static constexpr int CompactTries = 4;
+    static constexpr size_t ReorganizeBatchSize = 16;
 private:
     size_t _elemCount = 0;
     size_t _nextResize = StartResizeTrehsold;
@@ -157,6 +450,15 @@ template <
     class ItemT,
     class ComparerT
 > class LinkedListBucketT {
+    /*                  Description
+     *  Bucket keeping its elements in singly linked list after sentinel root node, every node is allocated separately.
+     *
+     *  compact() moves the sentinel and all nodes into single arena allocation, in chain order, so traversal
+     *  becomes sequential memory access again after long insert/remove churn. Later inserts allocate separate nodes
+     *  as usual, removed arena nodes are only unlinked - their memory is reclaimed by next compact() or destruction.
+     *  Arena nodes are owned by the bucket, so rehash turns them back into separately allocated nodes first.
+     */
+
     // ------------------------------
     // Inner types
     // ------------------------------
@@ -168,7 +470,7 @@ template <
         node(const node& other): _item(other._item), _key(other._key){}
 
         node* next{};
-        ItemT _item;
+        [[no_unique_address]] ItemT _item; // takes no space for EmptyItem
         KeyT _key;
     };
 
@@ -186,18 +488,20 @@ public:
     }
 
     LinkedListBucketT(LinkedListBucketT&& other) noexcept:
-        _elemCount(other._elemCount), _root(other._root)
+        _elemCount(other._elemCount), _root(other._root), _arenaSize(other._arenaSize)
     {
         other._root = nullptr;
         other._elemCount = 0;
+        other._arenaSize = 0;
     }
 
     LinkedListBucketT& operator=(const LinkedListBucketT& other) {
         if (&other == this) return *this;
 
-        cleanList(_root);
+        _cleanNodes();
         _root = cloneList(other._root);
         _elemCount = other._elemCount;
+        _arenaSize = 0;
 
         return *this;
     }
@@ -205,18 +509,20 @@ public:
     LinkedListBucketT& operator=(LinkedListBucketT&& other) noexcept {
         if (&other == this) return *this;
 
-        cleanList(_root);
+        _cleanNodes();
         _root = other._root;
         _elemCount = other._elemCount;
+        _arenaSize = other._arenaSize;
 
         other._root = nullptr;
         other._elemCount = 0;
+        other._arenaSize = 0;
 
         return *this;
     }
 
     ~LinkedListBucketT() {
-        cleanList(_root);
+        _cleanNodes();
     }
 
     // ------------------------------
@@ -244,30 +550,45 @@ public:
     }
 
     [[nodiscard]] bool search(const KeyT& key) const {
-        node* root = _root;
+        return find(key) != nullptr;
+    }
+
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        const node* root = _root;
 
         // look through all nodes
         while((root = root->next)) {
-            if (_comp(root->key, key)) return true;
+            if (_comp(root->_key, key)) return &root->_item;
         }
 
-        return false;
+        return nullptr;
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        return const_cast<ItemT*>(std::as_const(*this).find(key));
+    }
+
+    template<class FuncT>
+    void forEach(FuncT&& func) const {
+        for (const node* n = _root->next; n; n = n->next) func(n->_key, n->_item);
     }
 
     bool safeRemove(const KeyT& key) {
-        node** root = _root;
+        node* prev = _root;
 
         // find key inside the list
-        while((root = &(*root)->next)) {
+        while(prev->next) {
 
             // remove the key
-            if (_comp((*root)->key, key)) {
-                node* toRemove = *root;
-                *root = toRemove->next;
-                delete toRemove;
+            if (_comp(prev->next->_key, key)) {
+                node* toRemove = prev->next;
+                prev->next = toRemove->next;
+                _freeNode(toRemove);
                 --_elemCount;
                 return true;
-            };
+            }
+
+            prev = prev->next;
         }
 
         return false;
@@ -297,8 +618,55 @@ public:
         safeRemove(key);
     }
 
+    // Moves sentinel and all nodes into single arena in chain order, does nothing when the bucket is already compact
+    void compact() {
+        if (_isCompact()) return;
+
+        node* arena = new node[_elemCount + 1];
+        node* tail = arena;
+
+        for (node* n = _root->next; n; n = n->next) {
+            tail->next = tail + 1;
+            ++tail;
+
+            tail->_key = std::move(n->_key);
+            tail->_item = std::move(n->_item);
+        }
+        tail->next = nullptr;
+
+        _cleanNodes();
+        _root = arena;
+        _arenaSize = _elemCount + 1;
+    }
+
     template<class OuterHashFuncT>
-    [[nodiscard]] static std::vector<LinkedListBucketT> reorganizeBuckets(std::vector<LinkedListBucketT> oldBuckets, size_t nSize, OuterHashFuncT nFunc) {
+    [[nodiscard]] static std::vector<LinkedListBucketT> reorganizeBuckets(std::vector<LinkedListBucketT> oldBuckets, size_t nSize,
+        OuterHashFuncT nFunc, const size_t threadCount = 1)
+    {
+        // nodes are relinked into new buckets, so none of them can stay owned by arena of the old bucket
+        parallelForEachTask(threadCount, threadCount, [&](const size_t task) {
+            for (size_t i = oldBuckets.size() * task / threadCount; i < oldBuckets.size() * (task + 1) / threadCount; ++i)
+                oldBuckets[i]._releaseArena();
+        });
+
+        if (threadCount > 1) {
+            // nodes are relinked, not copied - old buckets have to forget them before being destroyed
+            auto nBuckets = scatterReorganizeBuckets<LinkedListBucketT, node*>(oldBuckets, nSize, nFunc, threadCount,
+                [](const LinkedListBucketT& bucket, auto&& emit) {
+                    for (node* n = bucket._root->next; n; n = n->next) emit(n->_key, n);
+                },
+                [](LinkedListBucketT& bucket, node* n) {
+                    bucket._attachFirst(n);
+                });
+
+            for (auto& oBucket : oldBuckets) {
+                oBucket._root->next = nullptr;
+                oBucket._elemCount = 0;
+            }
+
+            return nBuckets;
+        }
+
         std::vector<LinkedListBucketT> nBuckets(nSize);
 
         for (auto& oBucket : oldBuckets) {
@@ -332,12 +700,288 @@ private:
         ++_elemCount;
     }
 
+    [[nodiscard]] bool _isArenaNode(const node* n) const {
+        return std::less_equal<const node*>{}(_root, n) && std::less<const node*>{}(n, _root + _arenaSize);
+    }
+
+    // compact bucket holds exactly its elements inside the arena, in chain order
+    [[nodiscard]] bool _isCompact() const {
+        if (_arenaSize == 0) return _elemCount == 0;
+        if (_arenaSize != _elemCount + 1) return false;
+
+        const node* expected = _root;
+        for (const node* n = _root->next; n; n = n->next)
+            if (n != ++expected) return false;
+
+        return true;
+    }
+
+    void _freeNode(const node* n) const {
+        if (!_isArenaNode(n)) delete n;
+    }
+
+    void _cleanNodes() {
+        if (_arenaSize == 0) {
+            cleanList(_root);
+            return;
+        }
+
+        for (const node* n = _root->next; n; ) {
+            const node* next = n->next;
+            _freeNode(n);
+            n = next;
+        }
+
+        delete[] _root;
+        _root = nullptr;
+        _arenaSize = 0;
+    }
+
+    // moves elements of arena nodes into separately allocated nodes, separately allocated nodes are kept
+    void _releaseArena() {
+        if (_arenaSize == 0) return;
+
+        node* nRoot = new node{};
+        node* tail = nRoot;
+
+        for (node* n = _root->next; n; n = n->next) {
+            if (_isArenaNode(n)) {
+                tail->next = new node{};
+                tail->next->_key = std::move(n->_key);
+                tail->next->_item = std::move(n->_item);
+            }
+            else tail->next = n;
+
+            tail = tail->next;
+        }
+        tail->next = nullptr;
+
+        delete[] _root;
+        _root = nRoot;
+        _arenaSize = 0;
+    }
+
     // ------------------------------
     // Class fields
     // ------------------------------
 
     size_t _elemCount {};
     node* _root;
+    size_t _arenaSize{}; // node count of the arena starting at _root, 0 - root and all nodes allocated separately
+    inline static ComparerT _comp{};
+};
+
+template <
+    class KeyT,
+    class ItemT,
+    class ComparerT,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    size_t InlineCapacity = 3
+> class HybridHashBucketT {
+    /*                  Description
+     *  Bucket holding up to InlineCapacity elements directly inside its slot of the buckets vector,
+     *  with default parameters and 8-byte keys and items whole bucket takes 64 bytes. Buckets vector is not
+     *  cache line aligned, so the slot usually spans two neighbouring lines. Typical bucket of the map with load
+     *  factor around 1.0 therefore needs no allocation and its lookup touches no memory outside the slot.
+     *
+     *  When inline storage overflows, all elements are moved to the PlainHashBucketT (perfect hashing table).
+     *  Bucket returns to inline representation, when overflow table shrinks below InlineCapacity
+     *  or when the bucket is rebuilt during rehash.
+     */
+
+    using _overflowT = PlainHashBucketT<KeyT, ItemT, ComparerT, HashFuncT>;
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+    using InnerHashFuncT = HashFuncT;
+
+    HybridHashBucketT() = default;
+
+    HybridHashBucketT(const HybridHashBucketT& other):
+        _keys(other._keys), _items(other._items), _inlineCount(other._inlineCount),
+        _overflow(other._overflow ? new _overflowT(*other._overflow) : nullptr) {}
+
+    HybridHashBucketT(HybridHashBucketT&&) noexcept = default;
+
+    HybridHashBucketT& operator=(const HybridHashBucketT& other) {
+        if (&other == this) return *this;
+
+        _keys = other._keys;
+        _items = other._items;
+        _inlineCount = other._inlineCount;
+        _overflow.reset(other._overflow ? new _overflowT(*other._overflow) : nullptr);
+
+        return *this;
+    }
+
+    HybridHashBucketT& operator=(HybridHashBucketT&&) noexcept = default;
+
+    ~HybridHashBucketT() = default;
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    bool insert(const KeyT& key, const ItemT& item) {
+        if (_overflow) return _overflow->insert(key, item);
+        if (_findInline(key) != NotFound) return false;
+
+        _insertUnchecked(key, item);
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _overflow ? _overflow->size() : _inlineCount;
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return find(key) != nullptr;
+    }
+
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        if (_overflow) return std::as_const(*_overflow).find(key);
+
+        const size_t ind = _findInline(key);
+        return ind == NotFound ? nullptr : &_items[ind];
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        return const_cast<ItemT*>(std::as_const(*this).find(key));
+    }
+
+    template<class FuncT>
+    void forEach(FuncT&& func) const {
+        if (_overflow) {
+            _overflow->forEach(func);
+            return;
+        }
+
+        for (size_t i = 0; i < _inlineCount; ++i) func(_keys[i], _items[i]);
+    }
+
+    void compact() {
+        if (_overflow) _overflow->compact();
+    }
+
+    // NOTE: key must be contained in the bucket
+    void remove(const KeyT& key) {
+        safeRemove(key);
+    }
+
+    bool safeRemove(const KeyT& key) {
+        if (_overflow) {
+            if (!_overflow->safeRemove(key)) return false;
+            if (_overflow->size() < InlineCapacity) _moveToInline();
+            return true;
+        }
+
+        const size_t ind = _findInline(key);
+        if (ind == NotFound) return false;
+
+        // last element takes place of removed one
+        --_inlineCount;
+        _keys[ind] = std::move(_keys[_inlineCount]);
+        _items[ind] = std::move(_items[_inlineCount]);
+        return true;
+    }
+
+    [[nodiscard]] ItemT& get(const KeyT& key) {
+        return *find(key);
+    }
+
+    [[nodiscard]] ItemT& safeGet(const KeyT& key) {
+        if (ItemT* item = find(key)) return *item;
+
+        _insertUnchecked(key, ItemT{});
+        return *find(key);
+    }
+
+    template<class OuterHashFuncT>
+    static std::vector<HybridHashBucketT> reorganizeBuckets(std::vector<HybridHashBucketT> oldBuckets, size_t nSize,
+        OuterHashFuncT nFunc, const size_t threadCount = 1)
+    {
+        if (threadCount > 1)
+            return scatterReorganizeBuckets<HybridHashBucketT, std::pair<const KeyT*, const ItemT*>>(oldBuckets, nSize, nFunc, threadCount,
+                [](const HybridHashBucketT& bucket, auto&& emit) {
+                    bucket.forEach([&](const KeyT& key, const ItemT& item) { emit(key, std::make_pair(&key, &item)); });
+                },
+                [](HybridHashBucketT& bucket, const std::pair<const KeyT*, const ItemT*>& entry) {
+                    bucket._insertUnchecked(*entry.first, *entry.second);
+                });
+
+        std::vector<HybridHashBucketT> nBuckets(nSize);
+
+        for (const auto& oBucket : oldBuckets)
+            oBucket.forEach([&](const KeyT& key, const ItemT& item) {
+                nBuckets[nFunc(key)]._insertUnchecked(key, item);
+            });
+
+        return nBuckets;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] size_t _findInline(const KeyT& key) const {
+        for (size_t i = 0; i < _inlineCount; ++i)
+            if (_comp(_keys[i], key)) return i;
+
+        return NotFound;
+    }
+
+    // NOTE: key cannot be already contained in the bucket
+    void _insertUnchecked(const KeyT& key, const ItemT& item) {
+        if (_overflow) {
+            _overflow->insert(key, item);
+            return;
+        }
+
+        if (_inlineCount == InlineCapacity) {
+            _moveToOverflow();
+            _overflow->insert(key, item);
+            return;
+        }
+
+        _keys[_inlineCount] = key;
+        _items[_inlineCount] = item;
+        ++_inlineCount;
+    }
+
+    void _moveToOverflow() {
+        _overflow = std::make_unique<_overflowT>();
+
+        for (size_t i = 0; i < _inlineCount; ++i)
+            _overflow->insert(_keys[i], _items[i]);
+        _inlineCount = 0;
+    }
+
+    void _moveToInline() {
+        const std::unique_ptr<_overflowT> overflow = std::move(_overflow);
+        _inlineCount = 0;
+
+        overflow->forEach([&](const KeyT& key, const ItemT& item) {
+            _keys[_inlineCount] = key;
+            _items[_inlineCount] = item;
+            ++_inlineCount;
+        });
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t NotFound = SIZE_MAX;
+private:
+    std::array<KeyT, InlineCapacity> _keys{};
+    [[no_unique_address]] std::array<ItemT, InlineCapacity> _items{};
+    size_t _inlineCount{};
+
+    std::unique_ptr<_overflowT> _overflow{};
+
     inline static ComparerT _comp{};
 };
 
@@ -346,7 +990,8 @@ template<
     class ItemT,
     class ComparerT = std::equal_to<KeyT>,
     class HashFuncT = BaseHashFunction<KeyT, true>,
-    class BucketT = PlainHashBucketT<KeyT, ItemT, ComparerT>
+    class BucketT = PlainHashBucketT<KeyT, ItemT, ComparerT>,
+    class ResizePolicyT = ChainMapResizePolicy<>
 > class _chainHashingMapT {
     // ------------------------------
     // class creation
@@ -355,8 +1000,10 @@ public:
 
     _chainHashingMapT(): _chainHashingMapT(InitMapSize) {}
     explicit _chainHashingMapT(const size_t size):
-        _hFunc{size}, _nextUpScaleResize{static_cast<size_t>(size * _rehashPolicy)},
-        _nextDownScaleResize{size / DefaultDowscaleFactor}, _buckets(size) {}
+        _hFunc{ceilPow2(size)}, _buckets(ceilPow2(size))
+    {
+        _sizing.updateBarriers(_buckets.size());
+    }
 
     _chainHashingMapT(const _chainHashingMapT&) = default;
     _chainHashingMapT(_chainHashingMapT&&) = default;
@@ -379,7 +1026,7 @@ public:
 
         if (!_buckets[hash].insert(key, item)) return false;
 
-        if (++_elemCount > _nextUpScaleResize) _resize(_buckets.size() * 2);
+        if (_sizing.shouldGrow(++_elemCount)) _resize(_sizing.getGrowSize(_buckets.size()));
         return true;
     }
 
@@ -387,23 +1034,53 @@ public:
         return _buckets[_hFunc(key)].search(key);
     }
 
+    // Returns pointer to the item stored under the key or nullptr if key is not present.
+    // Const version does not modify the map, so it is safe to use it from many threads, when there are no writers.
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        return _buckets[_hFunc(key)].find(key);
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        return _buckets[_hFunc(key)].find(key);
+    }
+
+    // Performs find for count keys and saves pointers to results. Lookups are done in groups - all hashes
+    // of the group are computed and memory is prefetched before first comparison, so cache misses of
+    // different keys overlap instead of being paid one after another.
+    void findBatch(const KeyT* keys, const size_t count, const ItemT** results) const {
+        _findBatch(*this, keys, count, results);
+    }
+
+    void findBatch(const KeyT* keys, const size_t count, ItemT** results) {
+        _findBatch(*this, keys, count, results);
+    }
+
     // Note: element MUST be contained, otherwise behavior is undefined
     void remove(const KeyT& key) {
         _buckets[_hFunc(key)].remove(key);
 
-        if (--_elemCount < _nextDownScaleResize)
-            _resize(_buckets.size() / 2);
+        if (_sizing.shouldShrink(--_elemCount)) _resize(_sizing.getShrinkSize(_buckets.size()));
     }
 
     bool safeRemove(const KeyT& key) {
         const bool result = _buckets[_hFunc(key)].safeRemove(key);
 
-        if (result && --_elemCount < _nextDownScaleResize)
-            _resize(_buckets.size() / 2);
+        if (result && _sizing.shouldShrink(--_elemCount)) _resize(_sizing.getShrinkSize(_buckets.size()));
 
         return result;
     }
 
+    // Prepares map to hold elemCount elements without any rehashing. Map will not shrink below that size,
+    // until shrink_to_fit is called.
+    void reserve(const size_t elemCount) {
+        if (const size_t nSize = _sizing.reserve(elemCount, _buckets.size())) _resize(nSize);
+    }
+
+    // Drops reservation and resizes map to the smallest size, which fits actual elements.
+    void shrink_to_fit() {
+        if (const size_t nSize = _sizing.dropReservation(_elemCount, _buckets.size())) _resize(nSize);
+    }
+
     [[nodiscard]] size_t size() const {
         return _elemCount;
     }
@@ -417,11 +1094,34 @@ public:
     }
 
     [[nodiscard]] float max_load_factor() const {
-        return _rehashPolicy;
+        return _sizing.maxLoadFactor;
     }
 
     void max_load_factor(float nFactor) {
-        _rehashPolicy = nFactor;
+        _sizing.maxLoadFactor = nFactor;
+        _sizing.updateBarriers(_buckets.size());
+    }
+
+    // Writes flat image of the map, which can be loaded with MappedChainMap.
+    // Note: available only for PlainHashBucketT buckets with trivially copyable keys, items and hash functions,
+    //       throws std::runtime_error on I/O failure
+    void saveSnapshot(const std::string& path) const {
+        writeChainMapSnapshot<KeyT, ItemT>(path, _hFunc, _buckets, _elemCount);
+    }
+
+    // Sets number of threads used by full rehashes (including the calling one), rehashes of maps holding
+    // less than MinParallelRehashSize elements are always done by the calling thread only.
+    void setThreadCount(const size_t threadCount) {
+        _threadCount = std::max<size_t>(threadCount, 1);
+    }
+
+    [[nodiscard]] size_t getThreadCount() const {
+        return _threadCount;
+    }
+
+    // Returns number of full rehashes performed since creation of the map
+    [[nodiscard]] size_t getRehashCount() const {
+        return _sizing.rehashCount;
     }
 
     // Note: should only be used when preparing structure to be used in future without insertion and deletion
@@ -435,18 +1135,100 @@ public:
         return getAverageUsedBucketLoad() < desiredAverageBucketLoadRatio;
     }
 
+    // Prepares map for read-only phase: candidateCount hash functions are scored in parallel (see setThreadCount)
+    // by maximal bucket load and then by sum of squared bucket loads, which drives size of inner perfect hashing tables.
+    // Map is rebuilt once with the best one, sized to fit actual elements (reservation is dropped)
+    // and every bucket releases memory kept for future inserts. Returns maximal bucket load after rebuild.
+    size_t optimize(const size_t candidateCount = DefaultOptimizeCandidates) {
+        _sizing.minSize = InitMapSize;
+        const size_t nSize = _sizing.getFittingSize(_elemCount);
+
+        std::vector<KeyT> keys{};
+        keys.reserve(_elemCount);
+        for (const auto& bucket : _buckets)
+            bucket.forEach([&](const KeyT& key, const ItemT&) { keys.push_back(key); });
+
+        // actual function is also a candidate, when bucket count does not change
+        std::vector<HashFuncT> candidates{};
+        if (nSize == _buckets.size()) candidates.push_back(_hFunc);
+        while (candidates.size() < std::max<size_t>(candidateCount, 1)) candidates.emplace_back(nSize);
+
+        const size_t threads = _getRehashThreadCount();
+        const size_t workers = std::min(threads, candidates.size());
+        std::vector<std::pair<size_t, size_t>> scores(candidates.size());
+        std::atomic<size_t> nextCandidate{0};
+
+        // every worker reuses single loads array for all its candidates, so memory use does not grow with candidates
+        parallelForEachTask(workers, threads, [&](const size_t) {
+            std::vector<uint32_t> loads(nSize);
+
+            for (size_t candidate = nextCandidate++; candidate < candidates.size(); candidate = nextCandidate++) {
+                std::fill(loads.begin(), loads.end(), 0);
+                for (const auto& key : keys) ++loads[candidates[candidate](key)];
+
+                auto& [maxLoad, squareSum] = scores[candidate];
+                for (const size_t load : loads) {
+                    maxLoad = std::max(maxLoad, load);
+                    squareSum += load * load;
+                }
+            }
+        });
+
+        const size_t best = std::min_element(scores.begin(), scores.end()) - scores.begin();
+        keys = {};
+
+        _sizing.beginResize(nSize, _elemCount);
+        _hFunc = candidates[best];
+        _buckets = BucketT::reorganizeBuckets(std::move(_buckets), nSize, _hFunc, threads);
+        _compactBuckets(threads);
+
+        return scores[best].first;
+    }
+
+    // Compacts every bucket, which supports it (see bucket notes) - e.g. lays out nodes of linked list buckets
+    // contiguously after long insert/remove churn. Uses the same threads as full rehash.
+    void compact() {
+        _compactBuckets(_getRehashThreadCount());
+    }
+
+    // Incremental variant of compact() - compacts next bucketCount buckets, continuing where previous call stopped,
+    // so the work can be spread between other operations. Returns true, when the pass over all buckets was finished.
+    bool compactStep(const size_t bucketCount = DefaultCompactStep) {
+        if (_compactCursor >= _buckets.size()) _compactCursor = 0;
+
+        const size_t end = std::min(_buckets.size(), _compactCursor + bucketCount);
+        if constexpr (requires(BucketT& bucket) { bucket.compact(); })
+            for (size_t i = _compactCursor; i < end; ++i)
+                _buckets[i].compact();
+
+        _compactCursor = end;
+        return _compactCursor == _buckets.size();
+    }
+
     [[nodiscard]] ItemT& get(const KeyT& key) {
         return _buckets[_hFunc(key)].get(key);
     }
 
     [[nodiscard]] ItemT& operator[](const KeyT& key) {
-        return _buckets[_hFunc(key)].safeGet(key);
+        if (ItemT* item = find(key)) return *item;
+
+        // insertion goes through the map, so element is counted and resize may happen - bucket has to be found again
+        insert(key, ItemT{});
+        return *find(key);
     }
 
     [[nodiscard]] ItemT& operator[](const KeyT& key) const {
         return _buckets[_hFunc(key)].safeGet(key);
     }
 
+    // Calls func(key, item) for every element, order is defined by actual hash function.
+    // Note: visits every bucket, also empty ones
+    template<class FuncT>
+    void forEach(FuncT&& func) const {
+        for (const auto& bucket : _buckets)
+            bucket.forEach(func);
+    }
+
     [[nodiscard]] size_t getMaximalBucketLoad() const {
         size_t max = 0;
 
@@ -469,33 +1251,82 @@ public:
     // ------------------------------
 
 private:
+    template<class MapT, class ResultT>
+    static void _findBatch(MapT& map, const KeyT* keys, const size_t count, ResultT* results) {
+        size_t hashes[FindBatchSize];
+
+        for (size_t batch = 0; batch < count; batch += FindBatchSize) {
+            const size_t batchSize = std::min(FindBatchSize, count - batch);
+
+            for (size_t i = 0; i < batchSize; ++i) {
+                hashes[i] = map._hFunc(keys[batch + i]);
+                __builtin_prefetch(map._buckets.data() + hashes[i]);
+            }
+
+            if constexpr (requires(const BucketT& bucket, const KeyT& key) { bucket.prefetch(key); })
+                for (size_t i = 0; i < batchSize; ++i)
+                    map._buckets[hashes[i]].prefetch(keys[batch + i]);
+
+            for (size_t i = 0; i < batchSize; ++i)
+                results[batch + i] = map._buckets[hashes[i]].find(keys[batch + i]);
+        }
+    }
+
     void _resize(const size_t nSize) {
-        _nextUpScaleResize = static_cast<size_t>(nSize * _rehashPolicy);
-        _rehash(nSize);
+        if (_sizing.beginResize(nSize, _elemCount)) {
+            _rebuild(nSize);
+            return;
+        }
+
+        _hFunc = HashFuncT(nSize);
+        _buckets = std::vector<BucketT>(nSize);
     }
 
     void _rehash(const size_t size) {
+        ++_sizing.rehashCount;
+        _rebuild(size);
+    }
+
+    void _rebuild(const size_t size) {
         _hFunc = HashFuncT(size);
-        _buckets = std::move(BucketT::reorganizeBuckets(_buckets, size, _hFunc));
+        _buckets = BucketT::reorganizeBuckets(std::move(_buckets), size, _hFunc, _getRehashThreadCount());
+    }
+
+    [[nodiscard]] size_t _getRehashThreadCount() const {
+        return _elemCount >= MinParallelRehashSize ? _threadCount : 1;
+    }
+
+    void _compactBuckets(const size_t threads) {
+        if constexpr (requires(BucketT& bucket) { bucket.compact(); }) {
+            const size_t taskCount = threads * 4;
+            const size_t size = _buckets.size();
+
+            parallelForEachTask(taskCount, threads, [&](const size_t task) {
+                for (size_t i = size * task / taskCount; i < size * (task + 1) / taskCount; ++i)
+                    _buckets[i].compact();
+            });
+        }
     }
 
     // ------------------------------
     // class fields
     // ------------------------------
 public:
-    static constexpr double DefaultRehashPolicy = 1.0;
-    static constexpr size_t DefaultDowscaleFactor = 4;
-    static constexpr size_t InitMapSize = 8;
+    static constexpr double DefaultRehashPolicy = ChainMapSizing<ResizePolicyT>::DefaultRehashPolicy;
+    static constexpr size_t InitMapSize = ChainMapSizing<ResizePolicyT>::InitMapSize;
+    static constexpr size_t FindBatchSize = 16;
+    static constexpr size_t MinParallelRehashSize = 64 * 1024;
+    static constexpr size_t DefaultOptimizeCandidates = 16;
+    static constexpr size_t DefaultCompactStep = 1024;
 private:
     HashFuncT _hFunc;
 
-    float _rehashPolicy = DefaultRehashPolicy; // number used to deduce _nextRehash barrier
-
-    size_t _nextUpScaleResize; // next barrier, which overloading concludes to full rehash
-    size_t _nextDownScaleResize;
+    ChainMapSizing<ResizePolicyT> _sizing{};
     size_t _elemCount{}; // actual existing items in container
+    size_t _threadCount = 1; // threads used by full rehash
+    size_t _compactCursor{}; // next bucket compacted by compactStep
 
     std::vector<BucketT> _buckets{};
 };
 
-#endif //CHAINHASHINGMAP_H
+#endif //CHAINHASHINGMAP_H
\ No newline at end of file
@@ -0,0 +1,108 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef CHAINHASHINGSET_H
+#define CHAINHASHINGSET_H
+
+#include "chainHashingMap.h"
+
+#include <functional>
+#include <string>
+
+template<
+    class KeyT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, EmptyItem, ComparerT>,
+    class ResizePolicyT = ChainMapResizePolicy<>
+> class _chainHashingSetT {
+    /*                  Description
+     *  Key-only variant of _chainHashingMapT. Underlying map holds EmptyItem, which is not stored at all:
+     *  plain buckets keep no items table and list nodes contain only the key and the link,
+     *  so membership structures do not pay for unused items during insertion, rehashing or in snapshots.
+     *
+     *  Other bucket types can be used as long as they are instantiated with EmptyItem.
+     */
+
+    using _mapT = _chainHashingMapT<KeyT, EmptyItem, ComparerT, HashFuncT, BucketT, ResizePolicyT>;
+
+    // ------------------------------
+    // class creation
+    // ------------------------------
+public:
+
+    _chainHashingSetT() = default;
+    explicit _chainHashingSetT(const size_t size): _map(size) {}
+
+    // ------------------------------
+    // class interaction
+    // ------------------------------
+
+    // Returns true when key was added, false when it was already present
+    bool insert(const KeyT& key) {
+        return _map.insert(key, EmptyItem{});
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return _map.search(key);
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    void remove(const KeyT& key) {
+        _map.remove(key);
+    }
+
+    bool safeRemove(const KeyT& key) {
+        return _map.safeRemove(key);
+    }
+
+    void reserve(const size_t elemCount) {
+        _map.reserve(elemCount);
+    }
+
+    void shrink_to_fit() {
+        _map.shrink_to_fit();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _map.size();
+    }
+
+    [[nodiscard]] float load_factor() const {
+        return _map.load_factor();
+    }
+
+    [[nodiscard]] float max_load_factor() const {
+        return _map.max_load_factor();
+    }
+
+    void max_load_factor(const float nFactor) {
+        _map.max_load_factor(nFactor);
+    }
+
+    [[nodiscard]] size_t getMaxBucketSize() const {
+        return _map.getMaxBucketSize();
+    }
+
+    [[nodiscard]] size_t getMaximalBucketLoad() const {
+        return _map.getMaximalBucketLoad();
+    }
+
+    [[nodiscard]] size_t getRehashCount() const {
+        return _map.getRehashCount();
+    }
+
+    // Snapshot contains no items table, it can be loaded with MappedChainMap<KeyT, EmptyItem>
+    void saveSnapshot(const std::string& path) const {
+        _map.saveSnapshot(path);
+    }
+
+    // ------------------------------
+    // class fields
+    // ------------------------------
+private:
+    _mapT _map{};
+};
+
+#endif //CHAINHASHINGSET_H
@@ -0,0 +1,158 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef CHAINMAPSNAPSHOT_H
+#define CHAINMAPSNAPSHOT_H
+
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*                  IMPORTANT NOTES - SNAPSHOT FORMAT:
+ *
+ *  Snapshot is a flat binary image of _chainHashingMapT with PlainHashBucketT buckets,
+ *  which can be mapped into memory and queried without any deserialization (see MappedChainMap).
+ *  All offsets are counted from the beginning of the file and are aligned to SnapshotAlignment.
+ *
+ *  Layout:
+ *  - ChainMapSnapshotHeader,
+ *  - outer hash function object - raw bytes, padded,
+ *  - bucket directory - bucketCount entries, each: ChainMapSnapshotBucket + raw bytes of inner hash function, padded,
+ *  - bucket tables - for each non-empty bucket: keys[tableSize], items[tableSize], occupancy bytes[tableSize], each padded.
+ *
+ *  Hash functions, keys and items are stored as raw bytes, so all of them have to be trivially copyable.
+ *  Empty item types (sets) have no items table at all - it has size 0.
+ *  Snapshot is not portable between machines with different endianness or size_t width.
+ */
+
+static constexpr uint64_t SnapshotMagic = 0x50414d4e49414843; // "CHAINMAP"
+static constexpr uint32_t SnapshotVersion = 1;
+static constexpr size_t SnapshotAlignment = 8;
+
+struct ChainMapSnapshotHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t keySize;
+    uint32_t itemSize;
+    uint32_t outerHashSize;
+    uint32_t innerHashSize;
+    uint32_t bucketEntrySize; // size of single directory entry together with inner hash function
+    uint64_t elemCount;
+    uint64_t bucketCount;
+    uint64_t directoryOffset;
+    uint64_t fileSize;
+};
+
+struct ChainMapSnapshotBucket {
+    uint64_t tableOffset; // offset of keys table, items and occupancy tables follow it
+    uint64_t tableSize; // 0 means empty bucket without any tables
+};
+
+// Bytes used by single item inside the snapshot, empty items are not stored
+template<class ItemT>
+constexpr size_t SnapshotItemSize = std::is_empty_v<ItemT> ? 0 : sizeof(ItemT);
+
+constexpr size_t alignSnapshotOffset(const size_t offset) {
+    return (offset + SnapshotAlignment - 1) & ~(SnapshotAlignment - 1);
+}
+
+template<class T>
+constexpr size_t getSnapshotBucketEntrySize() {
+    return alignSnapshotOffset(sizeof(ChainMapSnapshotBucket) + sizeof(T));
+}
+
+template<class KeyT, class ItemT>
+constexpr size_t getSnapshotTableSize(const size_t tableSize) {
+    return alignSnapshotOffset(tableSize * sizeof(KeyT))
+        + alignSnapshotOffset(tableSize * SnapshotItemSize<ItemT>)
+        + alignSnapshotOffset(tableSize);
+}
+
+template<class KeyT, class ItemT, class OuterHashFuncT, class BucketT>
+void writeChainMapSnapshot(const std::string& path, const OuterHashFuncT& hFunc, const std::vector<BucketT>& buckets, const size_t elemCount)
+    // Note: throws std::runtime_error when file could not be written
+{
+    using InnerHashFuncT = typename BucketT::InnerHashFuncT;
+
+    static_assert(std::is_trivially_copyable_v<KeyT> && std::is_trivially_copyable_v<ItemT>,
+        "Only trivially copyable keys and items can be saved inside snapshot");
+    static_assert(std::is_trivially_copyable_v<OuterHashFuncT> && std::is_trivially_copyable_v<InnerHashFuncT>,
+        "Only trivially copyable hash functions can be saved inside snapshot");
+    static_assert(alignof(KeyT) <= SnapshotAlignment && alignof(ItemT) <= SnapshotAlignment
+        && alignof(InnerHashFuncT) <= SnapshotAlignment && alignof(OuterHashFuncT) <= SnapshotAlignment,
+        "Snapshot guarantees only 8-byte alignment");
+
+    static constexpr size_t bucketEntrySize = getSnapshotBucketEntrySize<InnerHashFuncT>();
+
+    ChainMapSnapshotHeader header{};
+    header.magic = SnapshotMagic;
+    header.version = SnapshotVersion;
+    header.keySize = sizeof(KeyT);
+    header.itemSize = SnapshotItemSize<ItemT>;
+    header.outerHashSize = sizeof(OuterHashFuncT);
+    header.innerHashSize = sizeof(InnerHashFuncT);
+    header.bucketEntrySize = bucketEntrySize;
+    header.elemCount = elemCount;
+    header.bucketCount = buckets.size();
+    header.directoryOffset = alignSnapshotOffset(sizeof(ChainMapSnapshotHeader)) + alignSnapshotOffset(sizeof(OuterHashFuncT));
+
+    // preparing directory with offsets of all tables
+    std::vector<char> directory(buckets.size() * bucketEntrySize);
+    size_t offset = header.directoryOffset + directory.size();
+
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        ChainMapSnapshotBucket entry{};
+
+        if (buckets[i].size() != 0) {
+            const auto& map = buckets[i].getUnderlyingMap();
+
+            entry.tableOffset = offset;
+            entry.tableSize = map.getSize();
+            offset += getSnapshotTableSize<KeyT, ItemT>(entry.tableSize);
+
+            const InnerHashFuncT& innerFunc = map.getHashFunc();
+            memcpy(directory.data() + i * bucketEntrySize + sizeof(ChainMapSnapshotBucket), &innerFunc, sizeof(InnerHashFuncT));
+        }
+
+        memcpy(directory.data() + i * bucketEntrySize, &entry, sizeof(ChainMapSnapshotBucket));
+    }
+    header.fileSize = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("[ ERROR ] Unable to open snapshot file for writing.");
+
+    static constexpr char padding[SnapshotAlignment]{};
+    auto writePadded = [&](const void* mem, const size_t bytes) {
+        file.write(static_cast<const char*>(mem), static_cast<std::streamsize>(bytes));
+        file.write(padding, static_cast<std::streamsize>(alignSnapshotOffset(bytes) - bytes));
+    };
+
+    writePadded(&header, sizeof(ChainMapSnapshotHeader));
+    writePadded(&hFunc, sizeof(OuterHashFuncT));
+    writePadded(directory.data(), directory.size());
+
+    std::vector<char> occupancy{};
+    for (const auto& bucket : buckets) {
+        if (bucket.size() == 0) continue;
+
+        const auto& [ keys, items, occup ] = bucket.getUnderlyingMap().getUnderlyingArrays();
+
+        occupancy.assign(occup.size(), 0);
+        occup.forEachSet([&](const size_t pos) { occupancy[pos] = 1; });
+        writePadded(keys.data(), keys.size() * sizeof(KeyT));
+        if constexpr (SnapshotItemSize<ItemT> != 0)
+            writePadded(items.data(), items.size() * sizeof(ItemT));
+        writePadded(occupancy.data(), occupancy.size());
+    }
+
+    if (!file)
+        throw std::runtime_error("[ ERROR ] Failed to write snapshot file.");
+}
+
+#endif //CHAINMAPSNAPSHOT_H
@@ -0,0 +1,155 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef CLOCKCACHE_H
+#define CLOCKCACHE_H
+
+#include "chainHashingMap.h"
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, size_t, ComparerT>
+>class _clockCacheT {
+    /*                  Description
+     *  Bounded cache with CLOCK (second chance) eviction. Entries live in fixed array allocated once
+     *  on construction, every entry holds its reference bit right next to the key and item,
+     *  so hits only set single flag instead of relinking any list. Chain map translates key into entry index.
+     *
+     *  When cache is full, clock hand sweeps entries in circular order: referenced entries get their bit
+     *  cleared and are skipped, first not referenced one is evicted. Frequently used entries are therefore
+     *  kept, while entries touched only once are evicted after single sweep.
+     */
+
+    struct entry {
+        KeyT key;
+        ItemT item;
+        bool referenced;
+    };
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // Note: throws std::runtime_error when capacity is 0
+    explicit _clockCacheT(const size_t capacity): _entries(capacity) {
+        if (capacity == 0)
+            throw std::runtime_error("[ ERROR ] Cache capacity has to be positive.");
+
+        // map never holds more keys than capacity, so it never rehashes
+        _indexes.reserve(capacity);
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Returns cached item, on miss loader(key) is called to get the item, which is cached before returning.
+    // Note: reference is valid only until next call of getOrLoad, which may evict the entry.
+    //       When loader throws, exception is propagated and cache stays unchanged.
+    template<class LoaderT>
+    [[nodiscard]] ItemT& getOrLoad(const KeyT& key, LoaderT&& loader) {
+        if (const size_t* index = _indexes.find(key)) {
+            ++_hits;
+
+            entry& e = _entries[*index];
+            e.referenced = true;
+            return e.item;
+        }
+
+        ++_misses;
+
+        // loaded before any eviction, so throwing loader leaves the cache untouched
+        ItemT item = loader(key);
+        const size_t index = _getFreeEntry();
+
+        entry& e = _entries[index];
+        e.key = key;
+        e.item = std::move(item);
+        e.referenced = true;
+        _indexes.insert(key, index);
+
+        return e.item;
+    }
+
+    // Returns cached item or nullptr, does not count as access - neither statistics nor reference bit change
+    [[nodiscard]] const ItemT* peek(const KeyT& key) const {
+        const size_t* index = _indexes.find(key);
+        return index ? &_entries[*index].item : nullptr;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _size;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return _entries.size();
+    }
+
+    [[nodiscard]] size_t getHitCount() const {
+        return _hits;
+    }
+
+    [[nodiscard]] size_t getMissCount() const {
+        return _misses;
+    }
+
+    [[nodiscard]] double getHitRatio() const {
+        const size_t accesses = _hits + _misses;
+        return accesses == 0 ? 0.0 : static_cast<double>(_hits) / accesses;
+    }
+
+    void resetStats() {
+        _hits = 0;
+        _misses = 0;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    // Returns index of entry, which can be overwritten - unused one or evicted by clock hand
+    size_t _getFreeEntry() {
+        if (_size < _entries.size()) return _size++;
+
+        while (_entries[_hand].referenced) {
+            _entries[_hand].referenced = false;
+            _advanceHand();
+        }
+
+        const size_t victim = _hand;
+        _advanceHand();
+        _indexes.remove(_entries[victim].key);
+
+        return victim;
+    }
+
+    void _advanceHand() {
+        if (++_hand == _entries.size()) _hand = 0;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+
+    std::vector<entry> _entries;
+    _chainHashingMapT<KeyT, size_t, ComparerT, HashFuncT, BucketT> _indexes{};
+
+    size_t _size{};
+    size_t _hand{};
+
+    size_t _hits{};
+    size_t _misses{};
+};
+
+#endif //CLOCKCACHE_H
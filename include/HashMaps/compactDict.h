@@ -0,0 +1,323 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef COMPACTDICT_H
+#define COMPACTDICT_H
+
+#include "HashFunctions.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    size_t HashRange = POW2FAST(55)
+>class _compactDictT {
+    /*                  Description
+     *  Insertion ordered map built in the same manner as CPython's dict. Elements are appended to dense entries
+     *  array, while sparse index table of 2^k slots holds only positions of entries. Slot width is chosen
+     *  by the capacity - 1, 2, 4 or 8 bytes, so for most maps sparse part costs only a few bytes per element
+     *  and iteration is linear scan over entries without touching the index at all.
+     *
+     *  Index is probed with open addressing using CPython perturbation scheme: i = 5 * i + 1 + perturb, where
+     *  perturb is hash shifted right by 5 bits on every step, so all hash bits take part in probing.
+     *  Keys are hashed with any functor from HashFunctions.h constructed with HashRange, result is mixed with
+     *  64-bit finalizer and stored in the entry, so neither probing nor resize recompute hashes.
+     *
+     *  Removed entries leave holes in entries array and dummy markers in the index, both are dropped
+     *  by the next resize, which happens when entries array (with holes) fills 2/3 of index slots.
+     */
+
+    struct entry {
+        size_t hash; // DeletedHash for removed entries
+        KeyT key;
+        ItemT item;
+    };
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    _compactDictT(): _compactDictT(0) {}
+
+    explicit _compactDictT(const size_t size): _hFunc(HashRange) {
+        _buildIndex(_getFittingSlots(size));
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    bool insert(std::pair<KeyT, ItemT> pair) {
+        const auto& [key, item] = pair;
+        return insert(key, item);
+    }
+
+    // Returns false and leaves actual item untouched, when key is already present
+    bool insert(const KeyT& key, const ItemT& item) {
+        const size_t hash = _getHash(key);
+        if (_lookup(key, hash) != NotFound) return false;
+
+        _insertNew(key, item, hash);
+        return true;
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return _lookup(key, _getHash(key)) != NotFound;
+    }
+
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        const size_t ind = _lookup(key, _getHash(key));
+        return ind == NotFound ? nullptr : &_entries[ind].item;
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        return const_cast<ItemT*>(std::as_const(*this).find(key));
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    [[nodiscard]] ItemT& get(const KeyT& key) {
+        return *find(key);
+    }
+
+    [[nodiscard]] ItemT& operator[](const KeyT& key) {
+        const size_t hash = _getHash(key);
+        if (const size_t ind = _lookup(key, hash); ind != NotFound) return _entries[ind].item;
+
+        _insertNew(key, ItemT{}, hash);
+        return _entries.back().item;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    void remove(const KeyT& key) {
+        safeRemove(key);
+    }
+
+    bool safeRemove(const KeyT& key) {
+        const size_t hash = _getHash(key);
+        const size_t slot = _lookupSlot(key, hash);
+        if (slot == NotFound) return false;
+
+        entry& e = _entries[_getIndex(slot)];
+        e = entry{ DeletedHash, KeyT{}, ItemT{} };
+        _setIndex(slot, DummyIndex);
+        --_elemCount;
+
+        return true;
+    }
+
+    // Calls func(key, item) for every element in insertion order
+    template<class FuncT>
+    void forEach(FuncT&& func) const {
+        for (const auto& e : _entries)
+            if (e.hash != DeletedHash) func(e.key, e.item);
+    }
+
+    template<class FuncT>
+    void forEach(FuncT&& func) {
+        for (auto& e : _entries)
+            if (e.hash != DeletedHash) func(e.key, e.item);
+    }
+
+    // Prepares dict to hold elemCount elements without any resize
+    void reserve(const size_t elemCount) {
+        if (const size_t slots = _getFittingSlots(elemCount); slots > _slotCount) _resize(slots);
+    }
+
+    // Drops holes left by removed elements and shrinks the index to fit actual elements
+    void shrink_to_fit() {
+        _resize(_getFittingSlots(_elemCount));
+        _entries.shrink_to_fit();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _elemCount;
+    }
+
+    [[nodiscard]] size_t getSlotCount() const {
+        return _slotCount;
+    }
+
+    // Returns width of single index slot in bytes
+    [[nodiscard]] size_t getIndexWidth() const {
+        return _indexWidth;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] size_t _getHash(const KeyT& key) const {
+        // highest bit is cleared, so no hash is equal to DeletedHash
+        return mixHash64(_hFunc(key)) >> 1;
+    }
+
+    // index table holds 2/3 of its slots at most
+    static size_t _getUsable(const size_t slots) {
+        return slots * 2 / 3;
+    }
+
+    static size_t _getFittingSlots(const size_t elemCount) {
+        return std::max(MinSlotCount, ceilPow2(elemCount * 3 / 2 + 1));
+    }
+
+    static size_t _getWidth(const size_t slots) {
+        if (slots <= POW2FAST(7)) return sizeof(int8_t);
+        if (slots <= POW2FAST(15)) return sizeof(int16_t);
+        if (slots <= POW2FAST(31)) return sizeof(int32_t);
+        return sizeof(int64_t);
+    }
+
+    // slots hold signed integers, so EmptyIndex and DummyIndex are representable in any width
+    [[nodiscard]] int64_t _getIndex(const size_t slot) const {
+        const uint8_t* ptr = _index.data() + slot * _indexWidth;
+
+        switch (_indexWidth) {
+            case sizeof(int8_t):
+                return static_cast<int8_t>(*ptr);
+            case sizeof(int16_t): {
+                int16_t val;
+                std::memcpy(&val, ptr, sizeof(val));
+                return val;
+            }
+            case sizeof(int32_t): {
+                int32_t val;
+                std::memcpy(&val, ptr, sizeof(val));
+                return val;
+            }
+            default: {
+                int64_t val;
+                std::memcpy(&val, ptr, sizeof(val));
+                return val;
+            }
+        }
+    }
+
+    void _setIndex(const size_t slot, const int64_t index) {
+        uint8_t* ptr = _index.data() + slot * _indexWidth;
+
+        switch (_indexWidth) {
+            case sizeof(int8_t):
+                *ptr = static_cast<uint8_t>(static_cast<int8_t>(index));
+                break;
+            case sizeof(int16_t): {
+                const auto val = static_cast<int16_t>(index);
+                std::memcpy(ptr, &val, sizeof(val));
+                break;
+            }
+            case sizeof(int32_t): {
+                const auto val = static_cast<int32_t>(index);
+                std::memcpy(ptr, &val, sizeof(val));
+                break;
+            }
+            default:
+                std::memcpy(ptr, &index, sizeof(index));
+        }
+    }
+
+    // Visits slots in CPython probing order until func returns true, returns that slot
+    template<class FuncT>
+    size_t _probe(const size_t hash, FuncT&& func) const {
+        const size_t mask = _slotCount - 1;
+        size_t slot = hash & mask;
+
+        for (size_t perturb = hash; !func(slot); ) {
+            perturb >>= PerturbShift;
+            slot = (slot * 5 + perturb + 1) & mask;
+        }
+
+        return slot;
+    }
+
+    // Returns slot of the index pointing to the key or NotFound
+    [[nodiscard]] size_t _lookupSlot(const KeyT& key, const size_t hash) const {
+        bool found = false;
+
+        const size_t slot = _probe(hash, [&](const size_t s) {
+            const int64_t ind = _getIndex(s);
+            if (ind == EmptyIndex) return true;
+            if (ind == DummyIndex) return false;
+
+            const entry& e = _entries[ind];
+            return found = e.hash == hash && _comp(e.key, key);
+        });
+
+        return found ? slot : NotFound;
+    }
+
+    // Returns position of the key in entries array or NotFound
+    [[nodiscard]] size_t _lookup(const KeyT& key, const size_t hash) const {
+        const size_t slot = _lookupSlot(key, hash);
+        return slot == NotFound ? NotFound : static_cast<size_t>(_getIndex(slot));
+    }
+
+    // NOTE: key cannot be already contained in the dict
+    void _insertNew(const KeyT& key, const ItemT& item, const size_t hash) {
+        // CPython growth rate - 3 slots per element, so after dropping holes dict is at most half full
+        if (_entries.size() >= _getUsable(_slotCount)) _resize(std::max(MinSlotCount, ceilPow2(_elemCount * 3)));
+
+        // key is absent, so also dummy slot can be reused
+        const size_t slot = _probe(hash, [&](const size_t s) { return _getIndex(s) < 0; });
+        _setIndex(slot, static_cast<int64_t>(_entries.size()));
+
+        _entries.push_back(entry{ hash, key, item });
+        ++_elemCount;
+    }
+
+    void _buildIndex(const size_t slots) {
+        _slotCount = slots;
+        _indexWidth = _getWidth(slots);
+        _index.assign(slots * _indexWidth, 0);
+
+        for (size_t slot = 0; slot < slots; ++slot)
+            _setIndex(slot, EmptyIndex);
+
+        for (size_t ind = 0; ind < _entries.size(); ++ind) {
+            const size_t slot = _probe(_entries[ind].hash, [&](const size_t s) { return _getIndex(s) == EmptyIndex; });
+            _setIndex(slot, static_cast<int64_t>(ind));
+        }
+
+        _entries.reserve(_getUsable(slots));
+    }
+
+    // drops holes keeping insertion order and rebuilds the index with given slot count
+    void _resize(const size_t slots) {
+        if (_elemCount != _entries.size())
+            std::erase_if(_entries, [](const entry& e) { return e.hash == DeletedHash; });
+
+        _buildIndex(slots);
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t MinSlotCount = 8;
+    static constexpr size_t NotFound = SIZE_MAX;
+    static constexpr size_t DeletedHash = SIZE_MAX;
+    static constexpr int64_t EmptyIndex = -1;
+    static constexpr int64_t DummyIndex = -2;
+    static constexpr int PerturbShift = 5;
+private:
+    HashFuncT _hFunc;
+
+    std::vector<entry> _entries{};
+    std::vector<uint8_t> _index{};
+    size_t _indexWidth{};
+    size_t _slotCount{};
+    size_t _elemCount{};
+
+    inline static ComparerT _comp{};
+};
+
+#endif //COMPACTDICT_H
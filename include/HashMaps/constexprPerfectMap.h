@@ -0,0 +1,187 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef CONSTEXPRPERFECTMAP_H
+#define CONSTEXPRPERFECTMAP_H
+
+#include "HashFunctions.h"
+#include "perfectHashHelpers.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+
+// Intentionally not constexpr - reaching it during constant evaluation stops compilation with its name in the message
+inline void perfectHashSearchFailed_IncreaseTableSize() {}
+
+template<
+    class KeyT,
+    class ItemT,
+    size_t N,
+    size_t TableSize = ceilPow2(N) * 2,
+    size_t (*HashableAccessor)(const KeyT& item) = [](const KeyT& item) { return static_cast<size_t>(item); },
+    class ComparerT = std::equal_to<KeyT>
+>class _constexprPerfectMapT {
+    /*                  Description
+     *  Lookup table over key set known at compile time, built during compilation with the same bucket-and-displace
+     *  scheme as _staticPerfectHashMapT. Single multiply-add of the key (parameters drawn from deterministic generator)
+     *  gives 64-bit hash, its top bits choose one of BucketCount buckets (about 2 keys each) and every bucket
+     *  stores 16-bit pilot, which is mixed into the remaining hash bits to get the slot:
+     *
+     *      h = a*x + b
+     *      slot = ((h >> 32) ^ ((pilot[h >> (64 - log2(BucketCount))] + 1) * mixer >> 32)) & (TableSize - 1)
+     *
+     *  Buckets are grouped and placed by PerfectHashBuckets - from the biggest one, every bucket gets the first pilot
+     *  moving all its keys into free slots.
+     *  Empty slots are filled with a key, which hashes to other slot, so lookup does no occupancy check.
+     *
+     *  Pilot search succeeds easily, when TableSize is about 2 * N (default), so key sets of thousands of keys are
+     *  fine. When it fails MaxAttempts times, compilation stops inside perfectHashSearchFailed_IncreaseTableSize,
+     *  then bigger TableSize should be passed or keys (their HashableAccessor values) are not distinct.
+     */
+
+    static_assert(N > 0, "Key set cannot be empty");
+    static_assert(TableSize >= N && (TableSize & (TableSize - 1)) == 0, "TableSize has to be power of 2 not lower than N");
+    static_assert(TableSize < POW2FAST(32), "Slot is taken from 32 bits of the hash, so table has to be smaller than 2^32");
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // Note: keys have to be distinct
+    consteval explicit _constexprPerfectMapT(const std::pair<KeyT, ItemT> (&pairs)[N]) {
+        uint64_t seed = SearchSeed;
+
+        for (size_t attempt = 0; attempt < MaxAttempts; ++attempt) {
+            _a = _splitMix(seed) | 1;
+            _b = _splitMix(seed);
+
+            if (_tryFill(pairs)) return;
+        }
+
+        perfectHashSearchFailed_IncreaseTableSize();
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Returns pointer to the item stored under the key or nullptr if key is not present
+    [[nodiscard]] constexpr const ItemT* find(const KeyT& key) const {
+        const size_t slot = _slot(key);
+        return _comp(_keys[slot], key) ? &_items[slot] : nullptr;
+    }
+
+    [[nodiscard]] constexpr bool search(const KeyT& key) const {
+        return _comp(_keys[_slot(key)], key);
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    [[nodiscard]] constexpr const ItemT& get(const KeyT& key) const {
+        return _items[_slot(key)];
+    }
+
+    [[nodiscard]] static constexpr size_t size() {
+        return N;
+    }
+
+    [[nodiscard]] static constexpr size_t getTableSize() {
+        return TableSize;
+    }
+
+    [[nodiscard]] static constexpr size_t getBucketCount() {
+        return BucketCount;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] constexpr uint64_t _hash(const KeyT& key) const {
+        return _a * HashableAccessor(key) + _b;
+    }
+
+    [[nodiscard]] static constexpr size_t _getBucket(const uint64_t hash) {
+        if constexpr (BucketBits == 0) return 0;
+        else return hash >> (64 - BucketBits);
+    }
+
+    [[nodiscard]] static constexpr size_t _getPosition(const uint64_t hash, const perfectHashPilotT pilot) {
+        return ((hash >> 32) ^ (mixPerfectHashPilot(pilot) >> 32)) & (TableSize - 1);
+    }
+
+    [[nodiscard]] constexpr size_t _slot(const KeyT& key) const {
+        const uint64_t hash = _hash(key);
+        return _getPosition(hash, _pilots[_getBucket(hash)]);
+    }
+
+    static constexpr uint64_t _splitMix(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    constexpr bool _tryFill(const std::pair<KeyT, ItemT> (&pairs)[N]) {
+        std::array<uint64_t, N> hashes{};
+        for (size_t i = 0; i < N; ++i) hashes[i] = _hash(pairs[i].first);
+
+        PerfectHashBuckets buckets{};
+        buckets.group(N, BucketCount, [&](const size_t i) { return _getBucket(hashes[i]); });
+
+        // pilot is xored into positions, so keys of one bucket with equal base position collide for every pilot
+        for (size_t b = 0; b < BucketCount; ++b)
+            for (size_t i = buckets.bucketStart[b]; i < buckets.bucketStart[b + 1]; ++i)
+                for (size_t j = buckets.bucketStart[b]; j < i; ++j)
+                    if (_getPosition(hashes[buckets.keys[i]], 0) == _getPosition(hashes[buckets.keys[j]], 0)) return false;
+
+        std::array<bool, TableSize> used{};
+        const bool placed = buckets.place(
+            [&](const size_t i, const perfectHashPilotT pilot) { return _getPosition(hashes[i], pilot); },
+            used,
+            [&](const size_t bucket, const perfectHashPilotT pilot) { _pilots[bucket] = pilot; });
+
+        if (!placed) return false;
+
+        for (size_t i = 0; i < N; ++i) {
+            const size_t slot = _getPosition(hashes[i], _pilots[_getBucket(hashes[i])]);
+
+            _keys[slot] = pairs[i].first;
+            _items[slot] = pairs[i].second;
+        }
+
+        // empty slots get a key from other slot - such key can never be looked up there
+        for (size_t slot = 0; slot < TableSize; ++slot) {
+            if (used[slot]) continue;
+
+            _keys[slot] = pairs[0].first;
+            _items[slot] = ItemT{};
+        }
+
+        return true;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t BucketCount = std::max<size_t>(1, TableSize / 4);
+    static constexpr size_t BucketBits = extractMSB(BucketCount);
+    static constexpr size_t MaxAttempts = 64;
+    static constexpr uint64_t SearchSeed = 0x2545F4914F6CDD1D;
+private:
+    uint64_t _a{};
+    uint64_t _b{};
+
+    std::array<perfectHashPilotT, BucketCount> _pilots{};
+    std::array<KeyT, TableSize> _keys{};
+    std::array<ItemT, TableSize> _items{};
+
+    static constexpr ComparerT _comp{};
+};
+
+#endif //CONSTEXPRPERFECTMAP_H
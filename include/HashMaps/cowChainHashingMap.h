@@ -0,0 +1,320 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef COWCHAINHASHINGMAP_H
+#define COWCHAINHASHINGMAP_H
+
+#include "chainHashingMap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, ItemT, ComparerT>,
+    class ResizePolicyT = ChainMapResizePolicy<>,
+    size_t PageSize = 64
+> class _cowChainHashingMapT {
+    /*                  Description
+     *  Variant of _chainHashingMapT supporting O(1) point-in-time snapshots. Buckets are split into pages
+     *  of PageSize buckets, pages and the page table (together with hash function) are reference counted.
+     *
+     *  snapshot() only shares the page table with the new map. First write to any of the maps, which share
+     *  the table, copies it (pointers to pages only), then every write copies the page it touches, if the page
+     *  is still shared - so untouched buckets are never copied. Full rehash builds new pages and does not touch
+     *  shared ones at all. Lookups pay two additional indirections comparing to _chainHashingMapT.
+     *
+     *  Snapshot can be read by other thread, while the original map is modified by its owner, as no shared
+     *  page is ever modified. Note: single map object is still not safe to use by many threads, when any of them writes.
+     *
+     *  Copy-on-write work is counted in Stats, write amplification is copiedBuckets / writes. Byte figures count
+     *  page tables and bucket slots of the pages, memory allocated by buckets themselves is not included.
+     */
+
+    static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize has to be power of 2");
+
+    using _pageT = std::vector<BucketT>;
+
+    struct _pageTable {
+        HashFuncT hFunc;
+        std::vector<std::shared_ptr<_pageT>> pages;
+    };
+
+    // ------------------------------
+    // Inner types
+    // ------------------------------
+public:
+
+    struct Stats {
+        size_t writes; // modifying operations
+        size_t copiedTables; // page tables copied on first write after snapshot
+        size_t copiedPages;
+        size_t copiedBuckets;
+        size_t copiedBytes; // bytes of copied page tables and pages
+        size_t pageCount;
+        size_t sharedPages; // pages referenced also by some other map
+        size_t exclusiveBytes; // bytes of page table and pages held only by this map
+        size_t sharedBytes; // bytes of page table and pages shared with snapshots
+    };
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+
+    _cowChainHashingMapT(): _cowChainHashingMapT(InitMapSize) {}
+    explicit _cowChainHashingMapT(const size_t size):
+        _table(_createTable(std::max(InitMapSize, ceilPow2(size)))), _bucketCount(std::max(InitMapSize, ceilPow2(size)))
+    {
+        _sizing.updateBarriers(_bucketCount);
+    }
+
+    // copying is O(1) - maps share all pages until they are modified
+    _cowChainHashingMapT(const _cowChainHashingMapT&) = default;
+    _cowChainHashingMapT(_cowChainHashingMapT&&) = default;
+    _cowChainHashingMapT& operator=(const _cowChainHashingMapT&) = default;
+    _cowChainHashingMapT& operator=(_cowChainHashingMapT&&) = default;
+
+    ~_cowChainHashingMapT() = default;
+
+    // Returns map sharing whole content with this one, statistics of the snapshot start from zero
+    [[nodiscard]] _cowChainHashingMapT snapshot() const {
+        _cowChainHashingMapT result(*this);
+        result._stats = {};
+
+        return result;
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    bool insert(std::pair<KeyT, ItemT> pair) {
+        const auto& [key, item] = pair;
+        return insert(key, item);
+    }
+
+    bool insert(const KeyT& key, const ItemT& item) {
+        const size_t hash = _table->hFunc(key);
+
+        // shared page is not copied for already present key
+        if (!_isPageExclusive(hash) && _getBucket(hash).search(key)) return false;
+        if (!_getWritableBucket(hash).insert(key, item)) return false;
+
+        if (_sizing.shouldGrow(++_elemCount)) _resize(_sizing.getGrowSize(_bucketCount));
+        return true;
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return _getBucket(_table->hFunc(key)).search(key);
+    }
+
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        return _getBucket(_table->hFunc(key)).find(key);
+    }
+
+    // Note: returned item can be modified, so its page is copied if shared, even if the key is not present
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        return _getWritableBucket(_table->hFunc(key)).find(key);
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    void remove(const KeyT& key) {
+        _getWritableBucket(_table->hFunc(key)).remove(key);
+
+        if (_sizing.shouldShrink(--_elemCount)) _resize(_sizing.getShrinkSize(_bucketCount));
+    }
+
+    bool safeRemove(const KeyT& key) {
+        const size_t hash = _table->hFunc(key);
+
+        if (!_isPageExclusive(hash) && !_getBucket(hash).search(key)) return false;
+        if (!_getWritableBucket(hash).safeRemove(key)) return false;
+
+        if (_sizing.shouldShrink(--_elemCount)) _resize(_sizing.getShrinkSize(_bucketCount));
+
+        return true;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    [[nodiscard]] ItemT& get(const KeyT& key) {
+        return *find(key);
+    }
+
+    [[nodiscard]] ItemT& operator[](const KeyT& key) {
+        if (ItemT* item = find(key)) return *item;
+
+        insert(key, ItemT{});
+        return *find(key);
+    }
+
+    void reserve(const size_t elemCount) {
+        if (const size_t nSize = _sizing.reserve(elemCount, _bucketCount)) _resize(nSize);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _elemCount;
+    }
+
+    [[nodiscard]] float load_factor() const {
+        return static_cast<float>(_elemCount) / _bucketCount;
+    }
+
+    [[nodiscard]] size_t getMaxBucketSize() const {
+        return _bucketCount;
+    }
+
+    [[nodiscard]] float max_load_factor() const {
+        return _sizing.maxLoadFactor;
+    }
+
+    void max_load_factor(const float nFactor) {
+        _sizing.maxLoadFactor = nFactor;
+        _sizing.updateBarriers(_bucketCount);
+    }
+
+    [[nodiscard]] size_t getRehashCount() const {
+        return _sizing.rehashCount;
+    }
+
+    [[nodiscard]] size_t getMaximalBucketLoad() const {
+        size_t max = 0;
+
+        for (const auto& page : _table->pages)
+            for (const auto& bucket : *page)
+                max = std::max(max, bucket.size());
+
+        return max;
+    }
+
+    // Note: counting shared pages scans whole page table
+    [[nodiscard]] Stats getStats() const {
+        Stats stats = _stats;
+        stats.pageCount = _table->pages.size();
+        stats.sharedPages = 0;
+        stats.exclusiveBytes = 0;
+        stats.sharedBytes = 0;
+
+        const bool tableExclusive = _isTableExclusive();
+        (tableExclusive ? stats.exclusiveBytes : stats.sharedBytes) += _getTableBytes(*_table);
+
+        for (const auto& page : _table->pages) {
+            const bool shared = !tableExclusive || page.use_count() > 1;
+
+            stats.sharedPages += shared;
+            (shared ? stats.sharedBytes : stats.exclusiveBytes) += _getPageBytes(*page);
+        }
+
+        return stats;
+    }
+
+    void resetStats() {
+        _stats = {};
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    static std::shared_ptr<_pageTable> _createTable(const size_t bucketCount) {
+        auto table = std::make_shared<_pageTable>(_pageTable{ HashFuncT(bucketCount), {} });
+
+        const size_t pageCount = (bucketCount + PageSize - 1) / PageSize;
+        table->pages.reserve(pageCount);
+        for (size_t i = 0; i < pageCount; ++i)
+            table->pages.push_back(std::make_shared<_pageT>(std::min(PageSize, bucketCount)));
+
+        return table;
+    }
+
+    // Only the owner of the map can add references to its table and pages, so exclusive object stays exclusive.
+    // Acquire fence pairs with release of the last other reference - reads of other owner finished before.
+    template<class T>
+    static bool _isExclusive(const std::shared_ptr<T>& ptr) {
+        if (ptr.use_count() != 1) return false;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    static size_t _getTableBytes(const _pageTable& table) {
+        return sizeof(_pageTable) + table.pages.size() * sizeof(std::shared_ptr<_pageT>);
+    }
+
+    static size_t _getPageBytes(const _pageT& page) {
+        return sizeof(_pageT) + page.size() * sizeof(BucketT);
+    }
+
+    [[nodiscard]] bool _isTableExclusive() const {
+        return _isExclusive(_table);
+    }
+
+    [[nodiscard]] bool _isPageExclusive(const size_t hash) const {
+        return _isTableExclusive() && _isExclusive(_table->pages[hash / PageSize]);
+    }
+
+    [[nodiscard]] const BucketT& _getBucket(const size_t hash) const {
+        return (*_table->pages[hash / PageSize])[hash % PageSize];
+    }
+
+    BucketT& _getWritableBucket(const size_t hash) {
+        ++_stats.writes;
+
+        if (!_isTableExclusive()) {
+            _table = std::make_shared<_pageTable>(*_table);
+            ++_stats.copiedTables;
+            _stats.copiedBytes += _getTableBytes(*_table);
+        }
+
+        auto& page = _table->pages[hash / PageSize];
+        if (!_isExclusive(page)) {
+            page = std::make_shared<_pageT>(*page);
+            ++_stats.copiedPages;
+            _stats.copiedBuckets += page->size();
+            _stats.copiedBytes += _getPageBytes(*page);
+        }
+
+        return (*page)[hash % PageSize];
+    }
+
+    // elements are copied into fresh pages, so old pages may stay shared with snapshots
+    void _resize(const size_t nSize) {
+        _sizing.beginResize(nSize, _elemCount);
+
+        auto nTable = _createTable(nSize);
+        for (const auto& page : _table->pages)
+            for (const auto& bucket : *page)
+                bucket.forEach([&](const KeyT& key, const ItemT& item) {
+                    const size_t hash = nTable->hFunc(key);
+                    (*nTable->pages[hash / PageSize])[hash % PageSize].insert(key, item);
+                });
+
+        _table = std::move(nTable);
+        _bucketCount = nSize;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr double DefaultRehashPolicy = ChainMapSizing<ResizePolicyT>::DefaultRehashPolicy;
+    static constexpr size_t InitMapSize = ChainMapSizing<ResizePolicyT>::InitMapSize;
+private:
+    std::shared_ptr<_pageTable> _table;
+    size_t _bucketCount;
+
+    ChainMapSizing<ResizePolicyT> _sizing{};
+    size_t _elemCount{};
+
+    Stats _stats{};
+};
+
+#endif //COWCHAINHASHINGMAP_H
@@ -0,0 +1,675 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef EXTENDIBLEFILEMAP_H
+#define EXTENDIBLEFILEMAP_H
+
+#include "chainHashingMap.h"
+
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*                  IMPORTANT NOTES - FILE FORMAT:
+ *
+ *  File is divided into PageSize pages, page 0 holds ExtendibleFileHeader followed by raw bytes of hash function.
+ *  Every other page is either bucket page or part of the directory.
+ *
+ *  Bucket page: ExtendibleFilePage header, then keys[capacity] and items[capacity], both aligned to their types.
+ *  Directory: 2^globalDepth page numbers (uint32_t) stored in directoryPages consecutive pages.
+ *
+ *  Directory is kept in memory and written only by flush() - into its previous pages, when it still fits there,
+ *  or appended to the end of the file otherwise (old directory pages are then left unused).
+ *  Keys, items and hash function are stored as raw bytes, so all of them have to be trivially copyable.
+ */
+
+static constexpr uint64_t ExtendibleFileMagic = 0x484658454c424954; // "TIBLEXFH"
+static constexpr uint32_t ExtendibleFileVersion = 1;
+
+struct ExtendibleFileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t pageSize;
+    uint32_t keySize;
+    uint32_t itemSize;
+    uint32_t hashSize;
+    uint32_t globalDepth;
+    uint64_t elemCount;
+    uint64_t pageCount;
+    uint64_t directoryPage;
+    uint64_t directoryPages;
+};
+
+struct ExtendibleFilePage {
+    uint32_t localDepth;
+    uint32_t count;
+};
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    size_t PageSize = 4096
+>class _extendiblePageBucketT {
+    /*                  Description
+     *  View over single bucket page of _extendibleFileMapT, follows the bucket interface of _chainHashingMapT
+     *  (insert, find, search, safeRemove, size, forEach). Elements are kept unordered in the first count slots,
+     *  so lookup is linear scan, which is negligible comparing to the cost of reading the page from the file.
+     */
+
+    static constexpr size_t _align(const size_t offset, const size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    static constexpr size_t _keysOffset = _align(sizeof(ExtendibleFilePage), alignof(KeyT));
+
+    static constexpr size_t _fitCapacity() {
+        size_t cap = (PageSize - _keysOffset) / (sizeof(KeyT) + sizeof(ItemT));
+        while (cap > 0 && _align(_keysOffset + cap * sizeof(KeyT), alignof(ItemT)) + cap * sizeof(ItemT) > PageSize)
+            --cap;
+
+        return cap;
+    }
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    explicit _extendiblePageBucketT(std::byte* page): _page(page) {}
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Note: bucket cannot be full and key cannot be already present
+    void insert(const KeyT& key, const ItemT& item) {
+        const uint32_t count = size();
+
+        _getKeys()[count] = key;
+        _getItems()[count] = item;
+        _setCount(count + 1);
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) const {
+        const uint32_t count = size();
+        const KeyT* keys = _getKeys();
+
+        for (uint32_t i = 0; i < count; ++i)
+            if (_comp(keys[i], key)) return _getItems() + i;
+
+        return nullptr;
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return find(key) != nullptr;
+    }
+
+    // last element takes place of the removed one
+    bool safeRemove(const KeyT& key) {
+        ItemT* item = find(key);
+        if (!item) return false;
+
+        const size_t pos = item - _getItems();
+        const uint32_t last = size() - 1;
+
+        _getKeys()[pos] = _getKeys()[last];
+        _getItems()[pos] = _getItems()[last];
+        _setCount(last);
+
+        return true;
+    }
+
+    template<class FuncT>
+    void forEach(FuncT&& func) const {
+        const uint32_t count = size();
+
+        for (uint32_t i = 0; i < count; ++i)
+            func(_getKeys()[i], _getItems()[i]);
+    }
+
+    // Clears the bucket and sets its depth
+    void reset(const uint32_t localDepth) {
+        const ExtendibleFilePage header{ localDepth, 0 };
+        memcpy(_page, &header, sizeof(ExtendibleFilePage));
+    }
+
+    [[nodiscard]] uint32_t size() const {
+        return _getHeader().count;
+    }
+
+    [[nodiscard]] bool isFull() const {
+        return size() == Capacity;
+    }
+
+    [[nodiscard]] uint32_t getLocalDepth() const {
+        return _getHeader().localDepth;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] ExtendibleFilePage _getHeader() const {
+        ExtendibleFilePage header;
+        memcpy(&header, _page, sizeof(ExtendibleFilePage));
+        return header;
+    }
+
+    void _setCount(const uint32_t count) {
+        ExtendibleFilePage header = _getHeader();
+        header.count = count;
+        memcpy(_page, &header, sizeof(ExtendibleFilePage));
+    }
+
+    [[nodiscard]] KeyT* _getKeys() const {
+        return reinterpret_cast<KeyT*>(_page + _keysOffset);
+    }
+
+    [[nodiscard]] ItemT* _getItems() const {
+        return reinterpret_cast<ItemT*>(_page + ItemsOffset);
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t Capacity = _fitCapacity();
+    static constexpr size_t ItemsOffset = _align(_keysOffset + Capacity * sizeof(KeyT), alignof(ItemT));
+private:
+    std::byte* _page;
+
+    inline static ComparerT _comp{};
+};
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    size_t HashRange = POW2FAST(55),
+    size_t PageSize = 4096
+>class _extendibleFileMapT {
+    /*                  Description
+     *  Disk resident map based on extendible hashing, for data sets larger than available memory.
+     *  Buckets are PageSize pages of the file, in-memory directory of 2^globalDepth entries maps lowest
+     *  globalDepth bits of key hash to the bucket page. Keys are hashed with any functor from HashFunctions.h
+     *  constructed with HashRange, result is mixed with 64-bit finalizer, so low bits are well distributed.
+     *
+     *  Full bucket of localDepth < globalDepth is split into itself and single new page, by the hash bit localDepth,
+     *  only directory entries pointing to it are updated. When localDepth == globalDepth, directory is doubled first,
+     *  which is pure memory operation - so every split touches exactly two pages and never rehashes the whole map.
+     *
+     *  Pages are accessed through small page cache with CLOCK eviction (the same as _clockCacheT), dirty pages
+     *  are written back on eviction and by flush(). Lookup reads at most one page from the file.
+     *  Removal never merges buckets nor shrinks the directory.
+     *
+     *  Note: destructor flushes the map, but I/O errors can be observed only by explicit flush() call.
+     */
+
+    using _bucketT = _extendiblePageBucketT<KeyT, ItemT, ComparerT, PageSize>;
+
+    struct alignas(64) _pageBuffer {
+        std::byte data[PageSize];
+    };
+
+    struct _frame {
+        uint32_t pageId;
+        bool referenced;
+        bool dirty;
+    };
+
+    // closes the descriptor, moved from handle holds -1
+    struct _fileHandle {
+        int fd = -1;
+
+        explicit _fileHandle(const int fd): fd(fd) {}
+        _fileHandle(_fileHandle&& other) noexcept: fd(std::exchange(other.fd, -1)) {}
+        _fileHandle& operator=(_fileHandle&&) = delete;
+        ~_fileHandle() { if (fd != -1) close(fd); }
+    };
+
+    static_assert(std::is_trivially_copyable_v<KeyT> && std::is_trivially_copyable_v<ItemT>,
+        "Keys and items are stored as raw bytes, so they have to be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<HashFuncT>, "Hash function is stored as raw bytes");
+    static_assert(alignof(KeyT) <= 64 && alignof(ItemT) <= 64, "Keys and items cannot be aligned above page buffers");
+    static_assert(_bucketT::Capacity >= 2, "Page has to hold at least two elements");
+    static_assert(sizeof(ExtendibleFileHeader) + sizeof(HashFuncT) <= PageSize, "Header does not fit into single page");
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // Opens map stored in the file or creates new one, when the file is empty or does not exist.
+    // Note: throws std::runtime_error when file could not be opened or contains map saved with different types
+    explicit _extendibleFileMapT(const std::string& path, const size_t cachePages = DefaultCachePages):
+        _file(open(path.c_str(), O_RDWR | O_CREAT, 0644)), _hFunc(HashRange), _frames(cachePages), _buffers(cachePages)
+    {
+        if (_file.fd == -1)
+            throw std::runtime_error("[ ERROR ] Unable to open extendible map file.");
+
+        if (cachePages == 0)
+            throw std::runtime_error("[ ERROR ] Page cache has to hold at least one page.");
+
+        _cachedPages.reserve(cachePages);
+
+        struct stat st{};
+        if (fstat(_file.fd, &st) == -1)
+            throw std::runtime_error("[ ERROR ] Unable to read size of extendible map file.");
+
+        if (st.st_size == 0) _initFile();
+        else _loadFile();
+    }
+
+    _extendibleFileMapT(const _extendibleFileMapT&) = delete;
+    _extendibleFileMapT& operator=(const _extendibleFileMapT&) = delete;
+
+    _extendibleFileMapT(_extendibleFileMapT&&) = default;
+    _extendibleFileMapT& operator=(_extendibleFileMapT&&) = delete;
+
+    ~_extendibleFileMapT() {
+        if (_file.fd == -1) return;
+
+        try {
+            flush();
+        }
+        catch (...) {}
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    bool insert(std::pair<KeyT, ItemT> pair) {
+        const auto& [key, item] = pair;
+        return insert(key, item);
+    }
+
+    // Returns false and leaves actual item untouched, when key is already present
+    // Note: throws std::runtime_error on I/O failure
+    bool insert(const KeyT& key, const ItemT& item) {
+        const size_t hash = _getHash(key);
+
+        while (true) {
+            const size_t frame = _fetch(_getPageId(hash));
+            _bucketT bucket = _getBucket(frame);
+
+            if (bucket.search(key)) return false;
+
+            if (!bucket.isFull()) {
+                bucket.insert(key, item);
+                _frames[frame].dirty = true;
+                ++_elemCount;
+
+                return true;
+            }
+
+            _split(hash);
+        }
+    }
+
+    // Inserts the key or replaces its item
+    void assign(const KeyT& key, const ItemT& item) {
+        const size_t frame = _fetch(_getPageId(_getHash(key)));
+
+        if (ItemT* actual = _getBucket(frame).find(key)) {
+            *actual = item;
+            _frames[frame].dirty = true;
+            return;
+        }
+
+        insert(key, item);
+    }
+
+    // Returns pointer to the item stored inside page cache or nullptr if key is not present.
+    // Note: pointer is valid only until next operation on the map, which may evict the page
+    [[nodiscard]] const ItemT* find(const KeyT& key) {
+        const size_t hash = _getHash(key);
+        return _getBucket(_fetch(_getPageId(hash))).find(key);
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) {
+        return find(key) != nullptr;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    void remove(const KeyT& key) {
+        safeRemove(key);
+    }
+
+    bool safeRemove(const KeyT& key) {
+        const size_t frame = _fetch(_getPageId(_getHash(key)));
+        if (!_getBucket(frame).safeRemove(key)) return false;
+
+        _frames[frame].dirty = true;
+        --_elemCount;
+
+        return true;
+    }
+
+    // Writes dirty pages, directory and header to the file and synchronizes it with the disk
+    // Note: throws std::runtime_error on I/O failure
+    void flush() {
+        for (size_t frame = 0; frame < _usedFrames; ++frame)
+            _writeBack(frame);
+
+        _writeDirectory();
+        _writeHeader();
+
+        if (fdatasync(_file.fd) == -1)
+            throw std::runtime_error("[ ERROR ] Unable to synchronize extendible map file.");
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _elemCount;
+    }
+
+    [[nodiscard]] size_t getGlobalDepth() const {
+        return _globalDepth;
+    }
+
+    [[nodiscard]] size_t getDirectorySize() const {
+        return _directory.size();
+    }
+
+    // Returns number of pages in the file, together with header and directory pages
+    [[nodiscard]] size_t getPageCount() const {
+        return _pageCount;
+    }
+
+    [[nodiscard]] size_t getSplitCount() const {
+        return _splitCount;
+    }
+
+    [[nodiscard]] size_t getPageReads() const {
+        return _pageReads;
+    }
+
+    [[nodiscard]] size_t getPageWrites() const {
+        return _pageWrites;
+    }
+
+    [[nodiscard]] size_t getCacheHits() const {
+        return _cacheHits;
+    }
+
+    void resetStats() {
+        _pageReads = 0;
+        _pageWrites = 0;
+        _cacheHits = 0;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] size_t _getHash(const KeyT& key) const {
+        return mixHash64(_hFunc(key));
+    }
+
+    [[nodiscard]] size_t _getPageId(const size_t hash) const {
+        return _directory[hash & (_directory.size() - 1)];
+    }
+
+    [[nodiscard]] _bucketT _getBucket(const size_t frame) {
+        return _bucketT(_buffers[frame].data);
+    }
+
+    // Returns frame holding the page, loading it from the file on miss
+    size_t _fetch(const size_t pageId) {
+        if (const size_t* frame = _cachedPages.find(pageId)) {
+            ++_cacheHits;
+            _frames[*frame].referenced = true;
+            return *frame;
+        }
+
+        const size_t frame = _acquireFrame(pageId);
+        _readPage(pageId, _buffers[frame].data);
+        return frame;
+    }
+
+    // Returns frame assigned to the page, previous page of the frame is written back when dirty.
+    // Content of the frame is left for the caller.
+    size_t _acquireFrame(const size_t pageId) {
+        size_t frame;
+
+        if (_usedFrames < _frames.size()) frame = _usedFrames++;
+        else {
+            while (_frames[_hand].referenced) {
+                _frames[_hand].referenced = false;
+                _advanceHand();
+            }
+
+            frame = _hand;
+            _advanceHand();
+
+            _writeBack(frame);
+            _cachedPages.remove(_frames[frame].pageId);
+        }
+
+        _frames[frame] = _frame{ static_cast<uint32_t>(pageId), true, false };
+        _cachedPages.insert(pageId, frame);
+
+        return frame;
+    }
+
+    void _advanceHand() {
+        if (++_hand == _frames.size()) _hand = 0;
+    }
+
+    void _writeBack(const size_t frame) {
+        if (!_frames[frame].dirty) return;
+
+        _writePage(_frames[frame].pageId, _buffers[frame].data);
+        _frames[frame].dirty = false;
+    }
+
+    // Splits bucket containing the hash into two pages by bit localDepth of the hash
+    void _split(const size_t hash) {
+        const size_t oldPage = _getPageId(hash);
+        const size_t oldFrame = _fetch(oldPage);
+        const uint32_t localDepth = _getBucket(oldFrame).getLocalDepth();
+
+        if (localDepth == _globalDepth) {
+            if (_globalDepth == MaxGlobalDepth)
+                throw std::runtime_error("[ ERROR ] Extendible map directory reached its maximal depth.");
+
+            // new half of the directory points to the same pages as the old one
+            const size_t dirSize = _directory.size();
+            _directory.resize(2 * dirSize);
+            std::copy(_directory.begin(), _directory.begin() + dirSize, _directory.begin() + dirSize);
+            ++_globalDepth;
+        }
+
+        if (_pageCount > MaxPageId)
+            throw std::runtime_error("[ ERROR ] Extendible map exceeded maximal page count.");
+
+        const size_t newPage = _pageCount++;
+        ++_splitCount;
+
+        // old page is copied aside, as acquiring frame for the new page may evict it
+        const _pageBuffer source = _buffers[oldFrame];
+        const _bucketT sourceBucket(const_cast<std::byte*>(source.data));
+
+        _bucketT oldBucket = _getBucket(oldFrame);
+        oldBucket.reset(localDepth + 1);
+        sourceBucket.forEach([&](const KeyT& key, const ItemT& item) {
+            if ((_getHash(key) >> localDepth & 1) == 0) oldBucket.insert(key, item);
+        });
+        _frames[oldFrame].dirty = true;
+
+        const size_t newFrame = _acquireFrame(newPage);
+        _bucketT newBucket = _getBucket(newFrame);
+        newBucket.reset(localDepth + 1);
+        sourceBucket.forEach([&](const KeyT& key, const ItemT& item) {
+            if ((_getHash(key) >> localDepth & 1) == 1) newBucket.insert(key, item);
+        });
+        _frames[newFrame].dirty = true;
+
+        // directory entries of the old bucket share lowest localDepth bits, half of them with bit localDepth set moves
+        const size_t step = POW2FAST(static_cast<int>(localDepth));
+        for (size_t ind = (hash & (step - 1)) | step; ind < _directory.size(); ind += 2 * step)
+            _directory[ind] = static_cast<uint32_t>(newPage);
+    }
+
+    void _initFile() {
+        _globalDepth = 0;
+        _pageCount = FirstBucketPage + 1;
+        _directory.assign(1, static_cast<uint32_t>(FirstBucketPage));
+
+        const size_t frame = _acquireFrame(FirstBucketPage);
+        _getBucket(frame).reset(0);
+        _frames[frame].dirty = true;
+
+        flush();
+    }
+
+    void _loadFile() {
+        _pageBuffer page;
+        _readPage(HeaderPage, page.data);
+
+        ExtendibleFileHeader header;
+        memcpy(&header, page.data, sizeof(ExtendibleFileHeader));
+
+        if (header.magic != ExtendibleFileMagic || header.version != ExtendibleFileVersion)
+            throw std::runtime_error("[ ERROR ] File does not contain supported extendible map.");
+
+        if (header.pageSize != PageSize || header.keySize != sizeof(KeyT) || header.itemSize != sizeof(ItemT)
+            || header.hashSize != sizeof(HashFuncT) || header.globalDepth > MaxGlobalDepth)
+            throw std::runtime_error("[ ERROR ] Extendible map was saved with different page, key, item or hash function types.");
+
+        std::array<std::byte, sizeof(HashFuncT)> hashBytes;
+        memcpy(hashBytes.data(), page.data + sizeof(ExtendibleFileHeader), sizeof(HashFuncT));
+        _hFunc = std::bit_cast<HashFuncT>(hashBytes);
+
+        _globalDepth = header.globalDepth;
+        _elemCount = header.elemCount;
+        _pageCount = header.pageCount;
+        _directoryPage = header.directoryPage;
+        _directoryPages = header.directoryPages;
+
+        _directory.resize(POW2FAST(static_cast<int>(_globalDepth)));
+        if (_getDirectoryPages(_directory.size()) > _directoryPages)
+            throw std::runtime_error("[ ERROR ] Extendible map file is corrupted.");
+
+        auto* dst = reinterpret_cast<std::byte*>(_directory.data());
+        const size_t bytes = _directory.size() * sizeof(uint32_t);
+
+        for (size_t offset = 0; offset < bytes; offset += PageSize) {
+            _readPage(_directoryPage + offset / PageSize, page.data);
+            memcpy(dst + offset, page.data, std::min(PageSize, bytes - offset));
+        }
+    }
+
+    static size_t _getDirectoryPages(const size_t entries) {
+        return (entries * sizeof(uint32_t) + PageSize - 1) / PageSize;
+    }
+
+    void _writeDirectory() {
+        const size_t pages = _getDirectoryPages(_directory.size());
+
+        // directory outgrew its pages - it is moved to the end of the file
+        if (pages > _directoryPages) {
+            _directoryPage = _pageCount;
+            _directoryPages = pages;
+            _pageCount += pages;
+        }
+
+        const auto* src = reinterpret_cast<const std::byte*>(_directory.data());
+        const size_t bytes = _directory.size() * sizeof(uint32_t);
+
+        _pageBuffer page{};
+        for (size_t offset = 0; offset < bytes; offset += PageSize) {
+            memcpy(page.data, src + offset, std::min(PageSize, bytes - offset));
+            _writePage(_directoryPage + offset / PageSize, page.data);
+        }
+    }
+
+    void _writeHeader() {
+        const ExtendibleFileHeader header{
+            ExtendibleFileMagic, ExtendibleFileVersion, static_cast<uint32_t>(PageSize),
+            static_cast<uint32_t>(sizeof(KeyT)), static_cast<uint32_t>(sizeof(ItemT)),
+            static_cast<uint32_t>(sizeof(HashFuncT)), static_cast<uint32_t>(_globalDepth),
+            _elemCount, _pageCount, _directoryPage, _directoryPages
+        };
+
+        _pageBuffer page{};
+        memcpy(page.data, &header, sizeof(ExtendibleFileHeader));
+        memcpy(page.data + sizeof(ExtendibleFileHeader), &_hFunc, sizeof(HashFuncT));
+        _writePage(HeaderPage, page.data);
+    }
+
+    void _readPage(const size_t pageId, std::byte* dst) {
+        ++_pageReads;
+
+        for (size_t done = 0; done < PageSize; ) {
+            const ssize_t result = pread(_file.fd, dst + done, PageSize - done, static_cast<off_t>(pageId * PageSize + done));
+
+            if (result <= 0)
+                throw std::runtime_error("[ ERROR ] Unable to read page of extendible map file.");
+            done += result;
+        }
+    }
+
+    void _writePage(const size_t pageId, const std::byte* src) {
+        ++_pageWrites;
+
+        for (size_t done = 0; done < PageSize; ) {
+            const ssize_t result = pwrite(_file.fd, src + done, PageSize - done, static_cast<off_t>(pageId * PageSize + done));
+
+            if (result < 0)
+                throw std::runtime_error("[ ERROR ] Unable to write page of extendible map file.");
+            done += result;
+        }
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t DefaultCachePages = 64;
+    static constexpr size_t MaxGlobalDepth = 30;
+    static constexpr size_t MaxPageId = UINT32_MAX;
+    static constexpr size_t HeaderPage = 0;
+    static constexpr size_t FirstBucketPage = 1;
+    static constexpr size_t BucketCapacity = _bucketT::Capacity;
+private:
+    _fileHandle _file;
+    HashFuncT _hFunc;
+
+    std::vector<uint32_t> _directory{};
+    size_t _globalDepth{};
+    size_t _elemCount{};
+    size_t _pageCount{};
+    size_t _directoryPage{};
+    size_t _directoryPages{};
+
+    // page cache
+    std::vector<_frame> _frames;
+    std::vector<_pageBuffer> _buffers;
+    _chainHashingMapT<size_t, size_t> _cachedPages{};
+    size_t _usedFrames{};
+    size_t _hand{};
+
+    size_t _splitCount{};
+    size_t _pageReads{};
+    size_t _pageWrites{};
+    size_t _cacheHits{};
+};
+
+#endif //EXTENDIBLEFILEMAP_H
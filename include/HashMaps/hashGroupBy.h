@@ -0,0 +1,214 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef HASHGROUPBY_H
+#define HASHGROUPBY_H
+
+#include "chainHashingMap.h"
+#include "../parallelHelpers.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template<
+    class KeyT,
+    class ValueT = int64_t,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, size_t, ComparerT>
+>class HashGroupBy {
+    /*                  Description
+     *  Group-by aggregation of key column with any number of value columns.
+     *  For every distinct key computes row count and sum, min and max of every value column.
+     *
+     *  Chain map is used only to translate key into dense group id, aggregates are held in flat arrays
+     *  indexed by group id (layout: group * columnCount + column). Rows are processed in batches:
+     *  first group ids of the whole batch are resolved with single findBatch call, which overlaps cache misses
+     *  of different keys, then every column is folded in separate tight loop, so hash lookups are not
+     *  interleaved with aggregate updates.
+     *
+     *  Parallel version splits rows into one range per thread, aggregates every range into private
+     *  HashGroupBy without any synchronization and merges partial results at the end.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    explicit HashGroupBy(const size_t columnCount = 0): _columnCount(columnCount) {}
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Note: every column has to contain keys.size() values, throws std::runtime_error otherwise
+    void consume(const std::vector<KeyT>& keys, const std::vector<std::vector<ValueT>>& columns) {
+        _validateColumns(keys, columns);
+        _consumeRange(keys, columns, 0, keys.size());
+    }
+
+    // Same as consume, but rows are aggregated by all threads of the pool
+    void consume(const std::vector<KeyT>& keys, const std::vector<std::vector<ValueT>>& columns, ThreadPool& pool) {
+        _validateColumns(keys, columns);
+
+        const size_t taskCount = std::max<size_t>(1, std::min(pool.getThreadCount(), keys.size() / MinRowsPerTask));
+        if (taskCount == 1) {
+            _consumeRange(keys, columns, 0, keys.size());
+            return;
+        }
+
+        std::vector<HashGroupBy> partials(taskCount, HashGroupBy(_columnCount));
+        pool.runTasks(taskCount, [&](const size_t task) {
+            partials[task]._consumeRange(keys, columns, keys.size() * task / taskCount, keys.size() * (task + 1) / taskCount);
+        });
+
+        for (const auto& partial : partials)
+            merge(partial);
+    }
+
+    // Folds results of other group-by into this one
+    void merge(const HashGroupBy& other) {
+        if (other._columnCount != _columnCount)
+            throw std::runtime_error("[ ERROR ] Unable to merge group-by results with different column count.");
+
+        for (size_t oGroup = 0; oGroup < other.getGroupCount(); ++oGroup) {
+            const size_t group = _getGroup(other._keys[oGroup]);
+
+            _counts[group] += other._counts[oGroup];
+            for (size_t col = 0; col < _columnCount; ++col) {
+                const size_t ind = group * _columnCount + col;
+                const size_t oInd = oGroup * _columnCount + col;
+
+                _sums[ind] += other._sums[oInd];
+                _mins[ind] = std::min(_mins[ind], other._mins[oInd]);
+                _maxes[ind] = std::max(_maxes[ind], other._maxes[oInd]);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t getGroupCount() const {
+        return _keys.size();
+    }
+
+    [[nodiscard]] size_t getColumnCount() const {
+        return _columnCount;
+    }
+
+    // Returns id of the group or NoGroup if key was never seen
+    [[nodiscard]] size_t findGroup(const KeyT& key) const {
+        const size_t* group = _groups.find(key);
+        return group ? *group : NoGroup;
+    }
+
+    [[nodiscard]] const KeyT& getKey(const size_t group) const {
+        return _keys[group];
+    }
+
+    [[nodiscard]] size_t getCount(const size_t group) const {
+        return _counts[group];
+    }
+
+    [[nodiscard]] ValueT getSum(const size_t group, const size_t column) const {
+        return _sums[group * _columnCount + column];
+    }
+
+    [[nodiscard]] ValueT getMin(const size_t group, const size_t column) const {
+        return _mins[group * _columnCount + column];
+    }
+
+    [[nodiscard]] ValueT getMax(const size_t group, const size_t column) const {
+        return _maxes[group * _columnCount + column];
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    void _validateColumns(const std::vector<KeyT>& keys, const std::vector<std::vector<ValueT>>& columns) const {
+        if (columns.size() != _columnCount)
+            throw std::runtime_error("[ ERROR ] Passed column count does not match the group-by definition.");
+
+        for (const auto& column : columns)
+            if (column.size() != keys.size())
+                throw std::runtime_error("[ ERROR ] Value column has different length than key column.");
+    }
+
+    // Returns id of the key group, creates new empty group for unseen keys
+    size_t _getGroup(const KeyT& key) {
+        if (const size_t* group = _groups.find(key)) return *group;
+
+        const size_t group = _keys.size();
+        _groups.insert(key, group);
+        _keys.push_back(key);
+        _counts.push_back(0);
+        _sums.resize(_sums.size() + _columnCount, ValueT{});
+        _mins.resize(_mins.size() + _columnCount, std::numeric_limits<ValueT>::max());
+        _maxes.resize(_maxes.size() + _columnCount, std::numeric_limits<ValueT>::lowest());
+
+        return group;
+    }
+
+    void _consumeRange(const std::vector<KeyT>& keys, const std::vector<std::vector<ValueT>>& columns,
+        const size_t begin, const size_t end)
+    {
+        size_t groupIds[BatchSize];
+        const size_t* found[BatchSize];
+
+        for (size_t batch = begin; batch < end; batch += BatchSize) {
+            const size_t batchSize = std::min(BatchSize, end - batch);
+            std::as_const(_groups).findBatch(keys.data() + batch, batchSize, found);
+
+            // insertion of new group may rehash the map, results found before are no longer valid after it
+            bool inserted = false;
+            for (size_t i = 0; i < batchSize; ++i) {
+                if (!inserted && found[i]) groupIds[i] = *found[i];
+                else {
+                    const size_t groupCount = _keys.size();
+                    groupIds[i] = _getGroup(keys[batch + i]);
+                    inserted |= _keys.size() != groupCount;
+                }
+
+                ++_counts[groupIds[i]];
+            }
+
+            for (size_t col = 0; col < _columnCount; ++col) {
+                const ValueT* values = columns[col].data() + batch;
+
+                for (size_t i = 0; i < batchSize; ++i) {
+                    const size_t ind = groupIds[i] * _columnCount + col;
+
+                    _sums[ind] += values[i];
+                    _mins[ind] = std::min(_mins[ind], values[i]);
+                    _maxes[ind] = std::max(_maxes[ind], values[i]);
+                }
+            }
+        }
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t BatchSize = 256;
+    static constexpr size_t MinRowsPerTask = 64 * 1024;
+    static constexpr size_t NoGroup = SIZE_MAX;
+private:
+    size_t _columnCount;
+
+    _chainHashingMapT<KeyT, size_t, ComparerT, HashFuncT, BucketT> _groups{};
+
+    std::vector<KeyT> _keys{};
+    std::vector<size_t> _counts{};
+    std::vector<ValueT> _sums{};
+    std::vector<ValueT> _mins{};
+    std::vector<ValueT> _maxes{};
+};
+
+#endif //HASHGROUPBY_H
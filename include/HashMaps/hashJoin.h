@@ -0,0 +1,264 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef HASHJOIN_H
+#define HASHJOIN_H
+
+#include "chainHashingMap.h"
+#include "../parallelHelpers.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+enum class HashJoinMode {
+    NoPartitioning,
+    RadixPartitioning
+};
+
+template<
+    class KeyT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, size_t, ComparerT>
+>class RadixHashJoin {
+    /*                  Description
+     *  Equi-join of two key columns. Result contains pair (build index, probe index) for every pair of equal keys,
+     *  duplicates on both sides are supported. Order of the result pairs is unspecified.
+     *
+     *  NoPartitioning mode:
+     *      single _chainHashingMapT is built over whole build column, then probe column is split into
+     *      chunks looked up concurrently. Map is built by one thread, because it is not thread safe.
+     *
+     *  RadixPartitioning mode:
+     *      both columns are scattered by hash into partitions (histogram, prefix sum, scatter - all parallel).
+     *      Partition count is chosen so that single partition map fits into half of the L2 cache.
+     *      Then every partition is built and probed independently by one worker, so both phases run in parallel
+     *      and all random accesses of the build and probe stay inside the cache.
+     *
+     *  Map stores for every distinct key index of its latest occurrence, earlier occurrences are chained
+     *  through separate "next" array.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+    using MatchT = std::pair<size_t, size_t>;
+
+    explicit RadixHashJoin(ThreadPool& pool, const HashJoinMode mode = HashJoinMode::RadixPartitioning):
+        _pool(pool), _mode(mode), _l2Size(_readL2Size()) {}
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    [[nodiscard]] std::vector<MatchT> join(const std::vector<KeyT>& build, const std::vector<KeyT>& probe) {
+        if (build.empty() || probe.empty()) {
+            _partitionCount = 0;
+            return {};
+        }
+
+        if (_mode == HashJoinMode::NoPartitioning) return _joinNoPartitioning(build, probe);
+        return _joinPartitioned(build, probe);
+    }
+
+    [[nodiscard]] HashJoinMode getMode() const {
+        return _mode;
+    }
+
+    // Returns number of partitions used by the last join, 1 for NoPartitioning mode
+    [[nodiscard]] size_t getPartitionCount() const {
+        return _partitionCount;
+    }
+
+    [[nodiscard]] size_t getL2CacheSize() const {
+        return _l2Size;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+    using _mapT = _chainHashingMapT<KeyT, size_t, ComparerT, HashFuncT, BucketT>;
+
+    // keys and original indexes of single column scattered by partitions
+    struct _partitionedColumn {
+        std::vector<KeyT> keys;
+        std::vector<size_t> indexes;
+        std::vector<size_t> partitionStart; // partitionCount + 1 entries
+    };
+
+    static size_t _readL2Size() {
+        const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        return size > 0 ? static_cast<size_t>(size) : DefaultL2Size;
+    }
+
+    [[nodiscard]] size_t _getPartitionCount(const size_t buildSize) const {
+        const size_t partitionBytes = std::max<size_t>(_l2Size / 2, 1);
+        return std::min(ceilPow2(buildSize * BuildTupleFootprint / partitionBytes), MaxPartitionCount);
+    }
+
+    [[nodiscard]] size_t _getChunkCount(const size_t elemCount) const {
+        return std::max<size_t>(1, std::min(_pool.getThreadCount() * ChunksPerThread, elemCount / MinChunkSize));
+    }
+
+    // Inserts index of key occurrence into map, chaining it with previous occurrences of the same key
+    static void _buildInsert(_mapT& map, std::vector<size_t>& next, const KeyT& key, const size_t index) {
+        if (size_t* head = map.find(key)) {
+            next[index] = *head;
+            *head = index;
+        }
+        else {
+            next[index] = NoNext;
+            map.insert(key, index);
+        }
+    }
+
+    std::vector<MatchT> _joinNoPartitioning(const std::vector<KeyT>& build, const std::vector<KeyT>& probe) {
+        _partitionCount = 1;
+
+        _mapT map{};
+        map.reserve(build.size());
+        std::vector<size_t> next(build.size());
+
+        for (size_t i = 0; i < build.size(); ++i)
+            _buildInsert(map, next, build[i], i);
+
+        const size_t chunkCount = _getChunkCount(probe.size());
+        std::vector<std::vector<MatchT>> results(chunkCount);
+
+        _pool.runTasks(chunkCount, [&](const size_t chunk) {
+            const size_t end = _getChunkStart(probe.size(), chunkCount, chunk + 1);
+            const _mapT& cMap = map;
+
+            for (size_t i = _getChunkStart(probe.size(), chunkCount, chunk); i < end; ++i)
+                if (const size_t* head = cMap.find(probe[i]))
+                    for (size_t b = *head; b != NoNext; b = next[b])
+                        results[chunk].emplace_back(b, i);
+        });
+
+        return _concatenate(results);
+    }
+
+    std::vector<MatchT> _joinPartitioned(const std::vector<KeyT>& build, const std::vector<KeyT>& probe) {
+        _partitionCount = _getPartitionCount(build.size());
+
+        // same function is used for both columns, so matching keys always land in partitions with the same index
+        const HashFuncT partitionFunc(_partitionCount);
+        const _partitionedColumn pBuild = _partition(build, partitionFunc);
+        const _partitionedColumn pProbe = _partition(probe, partitionFunc);
+
+        std::vector<std::vector<MatchT>> results(_partitionCount);
+        _pool.runTasks(_partitionCount, [&](const size_t part) {
+            const size_t bStart = pBuild.partitionStart[part];
+            const size_t bSize = pBuild.partitionStart[part + 1] - bStart;
+            const size_t pStart = pProbe.partitionStart[part];
+            const size_t pEnd = pProbe.partitionStart[part + 1];
+
+            if (bSize == 0 || pStart == pEnd) return;
+
+            // indexes inside the map are local to the partition
+            _mapT map{};
+            map.reserve(bSize);
+            std::vector<size_t> next(bSize);
+
+            for (size_t i = 0; i < bSize; ++i)
+                _buildInsert(map, next, pBuild.keys[bStart + i], i);
+
+            for (size_t i = pStart; i < pEnd; ++i)
+                if (const size_t* head = map.find(pProbe.keys[i]))
+                    for (size_t b = *head; b != NoNext; b = next[b])
+                        results[part].emplace_back(pBuild.indexes[bStart + b], pProbe.indexes[i]);
+        });
+
+        return _concatenate(results);
+    }
+
+    _partitionedColumn _partition(const std::vector<KeyT>& column, const HashFuncT& partitionFunc) {
+        const size_t chunkCount = _getChunkCount(column.size());
+
+        // histogram of every chunk, later transformed in place into write offsets of the chunk
+        std::vector<size_t> offsets(chunkCount * _partitionCount);
+
+        _pool.runTasks(chunkCount, [&](const size_t chunk) {
+            size_t* histogram = offsets.data() + chunk * _partitionCount;
+            const size_t end = _getChunkStart(column.size(), chunkCount, chunk + 1);
+
+            for (size_t i = _getChunkStart(column.size(), chunkCount, chunk); i < end; ++i)
+                ++histogram[partitionFunc(column[i])];
+        });
+
+        _partitionedColumn result{
+            std::vector<KeyT>(column.size()),
+            std::vector<size_t>(column.size()),
+            std::vector<size_t>(_partitionCount + 1)
+        };
+
+        // partitions are laid out one after another, inside partition chunks keep their order
+        size_t offset{};
+        for (size_t part = 0; part < _partitionCount; ++part) {
+            result.partitionStart[part] = offset;
+
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                const size_t count = offsets[chunk * _partitionCount + part];
+                offsets[chunk * _partitionCount + part] = offset;
+                offset += count;
+            }
+        }
+        result.partitionStart[_partitionCount] = offset;
+
+        _pool.runTasks(chunkCount, [&](const size_t chunk) {
+            size_t* writePos = offsets.data() + chunk * _partitionCount;
+            const size_t end = _getChunkStart(column.size(), chunkCount, chunk + 1);
+
+            for (size_t i = _getChunkStart(column.size(), chunkCount, chunk); i < end; ++i) {
+                const size_t pos = writePos[partitionFunc(column[i])]++;
+                result.keys[pos] = column[i];
+                result.indexes[pos] = i;
+            }
+        });
+
+        return result;
+    }
+
+    std::vector<MatchT> _concatenate(const std::vector<std::vector<MatchT>>& parts) {
+        std::vector<size_t> starts(parts.size() + 1);
+        for (size_t i = 0; i < parts.size(); ++i)
+            starts[i + 1] = starts[i] + parts[i].size();
+
+        std::vector<MatchT> result(starts.back());
+        _pool.runTasks(parts.size(), [&](const size_t part) {
+            std::copy(parts[part].begin(), parts[part].end(), result.begin() + starts[part]);
+        });
+
+        return result;
+    }
+
+    static size_t _getChunkStart(const size_t elemCount, const size_t chunkCount, const size_t chunk) {
+        return elemCount * chunk / chunkCount;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t DefaultL2Size = 256 * 1024;
+    static constexpr size_t MaxPartitionCount = 4096; // more partitions would thrash TLB during scatter
+    static constexpr size_t ChunksPerThread = 4;
+    static constexpr size_t MinChunkSize = 16 * 1024;
+
+    // rough estimate of bytes used per build tuple by partition map and chain arrays
+    static constexpr size_t BuildTupleFootprint = 8 * (sizeof(KeyT) + sizeof(size_t));
+    static constexpr size_t NoNext = SIZE_MAX;
+private:
+    ThreadPool& _pool;
+    HashJoinMode _mode;
+    size_t _l2Size;
+    size_t _partitionCount{};
+};
+
+#endif //HASHJOIN_H
@@ -0,0 +1,295 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include "HashFunctions.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+template<
+    class KeyT,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    size_t HashRange = POW2FAST(55)
+>class _hyperLogLogT {
+    /*                  Description
+     *  HyperLogLog++ distinct count sketch. Keys are hashed with any functor from HashFunctions.h constructed
+     *  with HashRange, result is mixed with 64-bit finalizer, top Precision bits select the register and
+     *  position of the first set bit of the rest is the rank stored inside it.
+     *
+     *  Sketch starts in sparse mode: pairs (25-bit index, rank) are collected in sorted list and estimated with
+     *  linear counting over 2^25 registers, which is almost exact for small cardinalities. When the list would
+     *  take more memory than dense registers, sketch is converted to 2^Precision byte registers.
+     *
+     *  Instead of empirical bias correction tables of HLL++ dense estimate uses improved estimator of O. Ertl
+     *  ("New cardinality estimation algorithms for HyperLogLog sketches"), which is unbiased over whole range.
+     *
+     *  Sketches can be merged only when they use the same hash function - so all sketches
+     *  processed by different threads should be created with emptyCopy() of single one.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // Note: throws std::runtime_error when precision is outside of [MinPrecision, MaxPrecision]
+    explicit _hyperLogLogT(const int precision = DefaultPrecision): _hyperLogLogT(HashFuncT(HashRange), precision) {}
+
+    _hyperLogLogT(const HashFuncT& hFunc, const int precision):
+        _precision(precision), _hFunc(hFunc)
+    {
+        if (precision < MinPrecision || precision > MaxPrecision)
+            throw std::runtime_error("[ ERROR ] HyperLogLog precision has to lie in range [4, 18].");
+    }
+
+    // Returns empty sketch, which shares hash function with this one, so both can be merged
+    [[nodiscard]] _hyperLogLogT emptyCopy() const {
+        return _hyperLogLogT(_hFunc, _precision);
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    void add(const KeyT& key) {
+        const uint64_t hash = mixHash64(_hFunc(key));
+
+        if (!_isSparse()) {
+            _updateRegister(hash >> (64 - _precision), _getRank(hash, _precision));
+            return;
+        }
+
+        _tmpSparse.push_back(_encodeSparse(hash));
+        if (_tmpSparse.size() >= _getTmpCapacity()) _flushSparse();
+    }
+
+    void merge(const _hyperLogLogT& other) {
+        if (other._precision != _precision)
+            throw std::runtime_error("[ ERROR ] Unable to merge HyperLogLog sketches with different precision.");
+
+        if (other._isSparse()) {
+            if (_isSparse()) {
+                _tmpSparse.insert(_tmpSparse.end(), other._sparse.begin(), other._sparse.end());
+                _tmpSparse.insert(_tmpSparse.end(), other._tmpSparse.begin(), other._tmpSparse.end());
+                _flushSparse();
+            }
+            else {
+                for (const uint32_t entry : other._sparse) _addSparseToDense(entry);
+                for (const uint32_t entry : other._tmpSparse) _addSparseToDense(entry);
+            }
+
+            return;
+        }
+
+        if (_isSparse()) _toDense();
+        _mergeRegisters(_registers.data(), other._registers.data(), _registers.size());
+    }
+
+    [[nodiscard]] double estimate() {
+        if (_isSparse()) {
+            _flushSparse();
+            if (_isSparse()) return _linearCounting(SparseRegisterCount, SparseRegisterCount - _sparse.size());
+        }
+
+        return _estimateDense();
+    }
+
+    [[nodiscard]] bool isSparse() const {
+        return _isSparse();
+    }
+
+    [[nodiscard]] int getPrecision() const {
+        return _precision;
+    }
+
+    // Standard error of the dense estimate
+    [[nodiscard]] double getRelativeError() const {
+        return 1.04 / std::sqrt(static_cast<double>(POW2FAST(_precision)));
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] bool _isSparse() const {
+        return _registers.empty();
+    }
+
+    // Returns position of the first set bit after skipping indexBits, counted from 1, at most 65 - indexBits
+    static uint8_t _getRank(const uint64_t hash, const int indexBits) {
+        return static_cast<uint8_t>(std::countl_zero((hash << indexBits) | (SIZE_ONE << (indexBits - 1))) + 1);
+    }
+
+    // sparse entry: 25-bit index << 6 | rank computed after 25 bits
+    static uint32_t _encodeSparse(const uint64_t hash) {
+        return static_cast<uint32_t>(hash >> (64 - SparsePrecision)) << RankBits | _getRank(hash, SparsePrecision);
+    }
+
+    static uint32_t _getSparseIndex(const uint32_t entry) {
+        return entry >> RankBits;
+    }
+
+    static uint8_t _getSparseRank(const uint32_t entry) {
+        return entry & ((1U << RankBits) - 1);
+    }
+
+    [[nodiscard]] size_t _getTmpCapacity() const {
+        return std::max<size_t>(MinTmpCapacity, POW2FAST(_precision) / 16);
+    }
+
+    // sorts buffered entries into the sparse list, only maximal rank per index is kept
+    void _flushSparse() {
+        if (_tmpSparse.empty()) return;
+
+        _tmpSparse.insert(_tmpSparse.end(), _sparse.begin(), _sparse.end());
+        std::sort(_tmpSparse.begin(), _tmpSparse.end());
+
+        _sparse.clear();
+        for (const uint32_t entry : _tmpSparse) {
+            // entries are sorted by index then rank - later entry of the same index has higher rank
+            if (!_sparse.empty() && _getSparseIndex(_sparse.back()) == _getSparseIndex(entry)) _sparse.back() = entry;
+            else _sparse.push_back(entry);
+        }
+        _tmpSparse.clear();
+
+        // 4 bytes per sparse entry vs 1 byte per dense register
+        if (_sparse.size() * sizeof(uint32_t) > POW2FAST(_precision)) _toDense();
+    }
+
+    void _toDense() {
+        _registers.assign(POW2FAST(_precision), 0);
+
+        for (const uint32_t entry : _sparse) _addSparseToDense(entry);
+        for (const uint32_t entry : _tmpSparse) _addSparseToDense(entry);
+
+        _sparse = {};
+        _tmpSparse = {};
+    }
+
+    void _addSparseToDense(const uint32_t entry) {
+        const uint32_t sparseIndex = _getSparseIndex(entry);
+        const int extraBits = SparsePrecision - _precision;
+        const uint32_t extra = sparseIndex & ((1U << extraBits) - 1);
+
+        // rank inside dense register is counted from extra index bits, when all of them are zero it continues into sparse rank
+        const uint8_t rank = extra != 0
+            ? static_cast<uint8_t>(std::countl_zero(extra) - (32 - extraBits) + 1)
+            : static_cast<uint8_t>(extraBits + _getSparseRank(entry));
+
+        _updateRegister(sparseIndex >> extraBits, rank);
+    }
+
+    void _updateRegister(const size_t index, const uint8_t rank) {
+        _registers[index] = std::max(_registers[index], rank);
+    }
+
+    static void _mergeRegisters(uint8_t* dst, const uint8_t* src, const size_t count) {
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        for (; i + 32 <= count; i += 32) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_max_epu8(a, b));
+        }
+#elif defined(__SSE2__)
+        for (; i + 16 <= count; i += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(a, b));
+        }
+#endif
+
+        for (; i < count; ++i)
+            dst[i] = std::max(dst[i], src[i]);
+    }
+
+    static double _linearCounting(const size_t registers, const size_t zeroRegisters) {
+        return registers * std::log(static_cast<double>(registers) / zeroRegisters);
+    }
+
+    [[nodiscard]] double _estimateDense() const {
+        const int q = 64 - _precision;
+        const auto m = static_cast<double>(_registers.size());
+
+        std::array<size_t, 66> histogram{};
+        for (const uint8_t reg : _registers) ++histogram[reg];
+
+        double z = m * _tau(1.0 - histogram[q + 1] / m);
+        for (int k = q; k >= 1; --k)
+            z = 0.5 * (z + histogram[k]);
+        z += m * _sigma(histogram[0] / m);
+
+        return AlphaInf * m * m / z;
+    }
+
+    static double _sigma(double x) {
+        if (x == 1.0) return std::numeric_limits<double>::infinity();
+
+        double y = 1.0;
+        double z = x;
+        double zPrev;
+
+        do {
+            x *= x;
+            zPrev = z;
+            z += x * y;
+            y += y;
+        } while (z != zPrev);
+
+        return z;
+    }
+
+    static double _tau(double x) {
+        if (x == 0.0 || x == 1.0) return 0.0;
+
+        double y = 1.0;
+        double z = 1.0 - x;
+        double zPrev;
+
+        do {
+            x = std::sqrt(x);
+            zPrev = z;
+            y *= 0.5;
+            z -= (1.0 - x) * (1.0 - x) * y;
+        } while (z != zPrev);
+
+        return z / 3.0;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr int MinPrecision = 4;
+    static constexpr int MaxPrecision = 18;
+    static constexpr int DefaultPrecision = 14;
+    static constexpr int SparsePrecision = 25;
+    static constexpr size_t SparseRegisterCount = POW2FAST(SparsePrecision);
+    static constexpr int RankBits = 6;
+    static constexpr size_t MinTmpCapacity = 64;
+    static constexpr double AlphaInf = 0.72134752044448170368; // 1 / (2 ln 2)
+private:
+    int _precision;
+    HashFuncT _hFunc;
+
+    std::vector<uint32_t> _sparse{}; // sorted by index, single entry per index
+    std::vector<uint32_t> _tmpSparse{}; // not yet sorted entries
+    std::vector<uint8_t> _registers{}; // empty in sparse mode
+};
+
+#endif //HYPERLOGLOG_H
@@ -0,0 +1,215 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef MAPPEDCHAINMAP_H
+#define MAPPEDCHAINMAP_H
+
+#include "HashFunctions.h"
+#include "chainMapSnapshot.h"
+
+#include <bit>
+#include <array>
+#include <functional>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class InnerHashFuncT = BaseHashFunction<KeyT, true>
+>class MappedChainMap {
+    /*                  Description
+     *  Read-only view over snapshot written by _chainHashingMapT::saveSnapshot.
+     *  File is mapped into the memory and lookups are answered directly from the mapping,
+     *  so opening the map costs only single mmap call, while the data is loaded lazily by page faults.
+     *
+     *  Template parameters have to match the ones used by the saved map, sizes are validated on open.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // Note: throws std::runtime_error when file could not be mapped or does not contain matching snapshot
+    explicit MappedChainMap(const std::string& path): MappedChainMap(_mapSnapshot(path)) {}
+
+    MappedChainMap(const MappedChainMap&) = delete;
+    MappedChainMap& operator=(const MappedChainMap&) = delete;
+
+    MappedChainMap(MappedChainMap&& other) noexcept:
+        _base(other._base), _directory(other._directory), _mapSize(other._mapSize),
+        _elemCount(other._elemCount), _hFunc(other._hFunc)
+    {
+        other._base = nullptr;
+    }
+
+    MappedChainMap& operator=(MappedChainMap&& other) noexcept {
+        if (&other == this) return *this;
+
+        _unmap();
+        _base = other._base;
+        _directory = other._directory;
+        _mapSize = other._mapSize;
+        _elemCount = other._elemCount;
+        _hFunc = other._hFunc;
+        other._base = nullptr;
+
+        return *this;
+    }
+
+    ~MappedChainMap() {
+        _unmap();
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Returns pointer to the item stored under the key or nullptr if key is not present
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        const char* entry = _directory + _hFunc(key) * BucketEntrySize;
+
+        ChainMapSnapshotBucket bucket;
+        memcpy(&bucket, entry, sizeof(ChainMapSnapshotBucket));
+        if (bucket.tableSize == 0) return nullptr;
+
+        const auto innerFunc = _readHashFunc<InnerHashFuncT>(entry + sizeof(ChainMapSnapshotBucket));
+        const size_t slot = innerFunc(key);
+
+        const char* keys = _base + bucket.tableOffset;
+        const char* items = keys + alignSnapshotOffset(bucket.tableSize * sizeof(KeyT));
+        const char* occup = items + alignSnapshotOffset(bucket.tableSize * SnapshotItemSize<ItemT>);
+
+        if (occup[slot] == 0 || !_comp(reinterpret_cast<const KeyT*>(keys)[slot], key)) return nullptr;
+
+        if constexpr (SnapshotItemSize<ItemT> == 0) return &_emptyItem;
+        else return reinterpret_cast<const ItemT*>(items) + slot;
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return find(key) != nullptr;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    [[nodiscard]] const ItemT& get(const KeyT& key) const {
+        return *find(key);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _elemCount;
+    }
+
+    [[nodiscard]] size_t getMaxBucketSize() const {
+        return _getHeader().bucketCount;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    struct _mapping {
+        const char* base;
+        size_t size;
+    };
+
+    explicit MappedChainMap(const _mapping mapping):
+        _base(mapping.base),
+        _directory(mapping.base + _getHeader(mapping.base).directoryOffset),
+        _mapSize(mapping.size),
+        _elemCount(_getHeader(mapping.base).elemCount),
+        _hFunc(_readHashFunc<HashFuncT>(mapping.base + alignSnapshotOffset(sizeof(ChainMapSnapshotHeader)))) {}
+
+    static _mapping _mapSnapshot(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error("[ ERROR ] Unable to open snapshot file.");
+
+        struct stat st{};
+        if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(ChainMapSnapshotHeader)) {
+            close(fd);
+            throw std::runtime_error("[ ERROR ] Snapshot file is too small to contain header.");
+        }
+
+        const auto size = static_cast<size_t>(st.st_size);
+        void* mem = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mem == MAP_FAILED)
+            throw std::runtime_error("[ ERROR ] Unable to map snapshot file.");
+
+        try {
+            _validateHeader(static_cast<const char*>(mem), size);
+        }
+        catch (...) {
+            munmap(mem, size);
+            throw;
+        }
+
+        // lookups are spread across the whole file, readahead would only waste the I/O
+        madvise(mem, size, MADV_RANDOM);
+        return { static_cast<const char*>(mem), size };
+    }
+
+    static const ChainMapSnapshotHeader& _getHeader(const char* base) {
+        return *reinterpret_cast<const ChainMapSnapshotHeader*>(base);
+    }
+
+    [[nodiscard]] const ChainMapSnapshotHeader& _getHeader() const {
+        return _getHeader(_base);
+    }
+
+    template<class FuncT>
+    static FuncT _readHashFunc(const char* mem) {
+        std::array<char, sizeof(FuncT)> bytes;
+        memcpy(bytes.data(), mem, sizeof(FuncT));
+        return std::bit_cast<FuncT>(bytes);
+    }
+
+    static void _validateHeader(const char* base, const size_t mapSize) {
+        const auto& header = _getHeader(base);
+
+        if (header.magic != SnapshotMagic || header.version != SnapshotVersion)
+            throw std::runtime_error("[ ERROR ] File does not contain supported chain map snapshot.");
+
+        if (header.keySize != sizeof(KeyT) || header.itemSize != SnapshotItemSize<ItemT>
+            || header.outerHashSize != sizeof(HashFuncT) || header.innerHashSize != sizeof(InnerHashFuncT)
+            || header.bucketEntrySize != BucketEntrySize)
+            throw std::runtime_error("[ ERROR ] Snapshot was saved with different key, item or hash function types.");
+
+        if (header.fileSize != mapSize
+            || header.directoryOffset + header.bucketCount * BucketEntrySize > mapSize)
+            throw std::runtime_error("[ ERROR ] Snapshot file is truncated.");
+    }
+
+    void _unmap() {
+        if (_base) munmap(const_cast<char*>(_base), _mapSize);
+        _base = nullptr;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t BucketEntrySize = getSnapshotBucketEntrySize<InnerHashFuncT>();
+private:
+    const char* _base{};
+    const char* _directory{};
+    size_t _mapSize{};
+    size_t _elemCount{};
+
+    // NOTE: copy of the outer function avoids reading it from mapping on every lookup
+    HashFuncT _hFunc;
+
+    inline static ComparerT _comp{};
+    inline static const ItemT _emptyItem{}; // returned by lookups of key-only snapshots
+};
+
+#endif //MAPPEDCHAINMAP_H
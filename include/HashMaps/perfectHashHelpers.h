@@ -0,0 +1,102 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef PERFECTHASHHELPERS_H
+#define PERFECTHASHHELPERS_H
+
+#include "HashFunctions.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/*                  Description
+ *  Bucket-and-displace construction shared by perfect hash maps (_staticPerfectHashMapT, _constexprPerfectMapT).
+ *  Keys are grouped into small buckets by one hash, then buckets are placed from the biggest one: every bucket
+ *  gets the first pilot, for which positions of all its keys are free. Position formula is up to the map, pilot
+ *  enters it through mixPerfectHashPilot. Everything is constexpr, so the same code runs during compilation.
+ */
+
+using perfectHashPilotT = uint16_t;
+
+static constexpr size_t PerfectHashMaxPilot = UINT16_MAX;
+static constexpr uint64_t PerfectHashPilotMixer = 0x9E3779B97F4A7C15;
+
+// Value xored into the hash of every key of the bucket with given pilot
+constexpr uint64_t mixPerfectHashPilot(const perfectHashPilotT pilot) {
+    return (pilot + SIZE_ONE) * PerfectHashPilotMixer;
+}
+
+struct PerfectHashBuckets {
+    // Groups key indexes [0, keyCount) by bucketOf(index) - counting sort, and orders buckets from the biggest one
+    template<class BucketOfT>
+    constexpr void group(const size_t keyCount, const size_t bucketCount, BucketOfT&& bucketOf) {
+        bucketStart.assign(bucketCount + 1, 0);
+        keys.resize(keyCount);
+        order.resize(bucketCount);
+
+        for (size_t i = 0; i < keyCount; ++i)
+            ++bucketStart[bucketOf(i) + 1];
+
+        size_t maxBucket{};
+        for (size_t b = 0; b < bucketCount; ++b) {
+            maxBucket = std::max(maxBucket, bucketStart[b + 1]);
+            bucketStart[b + 1] += bucketStart[b];
+        }
+
+        std::vector<size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+        for (size_t i = 0; i < keyCount; ++i)
+            keys[fill[bucketOf(i)]++] = i;
+
+        // the biggest buckets are placed first, while most of the slots are still free
+        std::vector<size_t> sizeStart(maxBucket + 2);
+        for (size_t b = 0; b < bucketCount; ++b)
+            ++sizeStart[maxBucket - getBucketSize(b) + 1];
+        for (size_t s = 0; s <= maxBucket; ++s)
+            sizeStart[s + 1] += sizeStart[s];
+        for (size_t b = 0; b < bucketCount; ++b)
+            order[sizeStart[maxBucket - getBucketSize(b)]++] = b;
+    }
+
+    // Searches pilots of all buckets, positionOf(keyIndex, pilot) returns slot of the key, taken marks used slots.
+    // setPilot(bucket, pilot) is called for every placed bucket. Returns false when some bucket cannot be placed.
+    template<class PositionT, class TakenT, class SetPilotT>
+    constexpr bool place(PositionT&& positionOf, TakenT& taken, SetPilotT&& setPilot) const {
+        for (const size_t b : order) {
+            const size_t first = bucketStart[b];
+            const size_t last = bucketStart[b + 1];
+            if (first == last) break; // empty buckets are at the end
+
+            bool placed = false;
+            for (size_t pilot = 0; pilot <= PerfectHashMaxPilot && !placed; ++pilot) {
+                const auto p = static_cast<perfectHashPilotT>(pilot);
+
+                size_t i = first;
+                while (i < last && !taken[positionOf(keys[i], p)])
+                    taken[positionOf(keys[i++], p)] = true;
+
+                // colliding keys of the same bucket are also caught by taken, so partial placement is rolled back
+                placed = i == last;
+                if (!placed)
+                    for (size_t j = first; j < i; ++j) taken[positionOf(keys[j], p)] = false;
+                else
+                    setPilot(b, p);
+            }
+
+            if (!placed) return false;
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] constexpr size_t getBucketSize(const size_t bucket) const {
+        return bucketStart[bucket + 1] - bucketStart[bucket];
+    }
+
+    std::vector<size_t> bucketStart{}; // keys of bucket b are keys[bucketStart[b], bucketStart[b + 1])
+    std::vector<size_t> keys{}; // key indexes grouped by buckets
+    std::vector<size_t> order{}; // buckets from the biggest one
+};
+
+#endif //PERFECTHASHHELPERS_H
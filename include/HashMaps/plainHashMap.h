@@ -7,8 +7,110 @@
 
 #include "HashFunctions.h"
 
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Item type of key-only containers (sets), it occupies no memory inside any map or bucket
+struct EmptyItem {};
+
+template<class ItemT>
+class _emptyItemStorage {
+    /*                  Description
+     *  Replacement of std::vector for empty item types. Remembers only the size,
+     *  all slots share single instance, so no memory is used per slot.
+     */
+
+public:
+    _emptyItemStorage() = default;
+    explicit _emptyItemStorage(const size_t size): _size(size) {}
+
+    [[nodiscard]] ItemT& operator[](size_t) { return _item; }
+    [[nodiscard]] const ItemT& operator[](size_t) const { return _item; }
+
+    [[nodiscard]] size_t size() const { return _size; }
+
+private:
+    size_t _size{};
+    [[no_unique_address]] ItemT _item{};
+};
+
+template<class ItemT>
+using ItemStorageT = std::conditional_t<std::is_empty_v<ItemT>, _emptyItemStorage<ItemT>, std::vector<ItemT>>;
+
+class OccupancyBitmap {
+    /*                  Description
+     *  Fixed size bitmap stored in 64-bit words. Unlike std::vector<bool> words are accessible directly,
+     *  so scans over set bits skip 64 empty slots at once and extract positions with bit tricks.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    OccupancyBitmap() = default;
+    explicit OccupancyBitmap(const size_t size): _words((size + WordBits - 1) / WordBits), _size(size) {}
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    [[nodiscard]] bool operator[](const size_t pos) const {
+        return _words[pos / WordBits] >> (pos % WordBits) & 1;
+    }
+
+    void set(const size_t pos) {
+        _words[pos / WordBits] |= SIZE_ONE << (pos % WordBits);
+    }
+
+    void reset(const size_t pos) {
+        _words[pos / WordBits] &= ~(SIZE_ONE << (pos % WordBits));
+    }
+
+    // Clears all bits
+    void clear() {
+        std::fill(_words.begin(), _words.end(), 0);
+    }
+
+    // Calls func(pos) for every set bit in ascending order
+    template<class FuncT>
+    void forEachSet(FuncT&& func) const {
+        for (size_t word = 0; word < _words.size(); ++word)
+            for (uint64_t bits = _words[word]; bits; bits &= bits - 1)
+                func(word * WordBits + std::countr_zero(bits));
+    }
+
+    // Calls pred(pos) for set bits in ascending order, stops and returns false at first pred returning false
+    template<class PredT>
+    bool allOfSet(PredT&& pred) const {
+        for (size_t word = 0; word < _words.size(); ++word)
+            for (uint64_t bits = _words[word]; bits; bits &= bits - 1)
+                if (!pred(word * WordBits + std::countr_zero(bits))) return false;
+
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _size;
+    }
+
+    [[nodiscard]] const std::vector<uint64_t>& getWords() const {
+        return _words;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t WordBits = 64;
+private:
+    std::vector<uint64_t> _words{};
+    size_t _size{};
+};
+
 template<
     class KeyT,
     class ItemT,
@@ -39,7 +141,7 @@ public:
 
         if (!_occupancyTable[hash]) {
             _items[hash] = item;
-            _occupancyTable[hash] = true;
+            _occupancyTable.set(hash);
 
             return true;
         }
@@ -59,20 +161,24 @@ public:
     }
 
     void remove(const KeyT& key) {
-        _occupancyTable[_hFunc(key)] = false;
+        _occupancyTable.reset(_hFunc(key));
     }
 
     void deepDelete(const KeyT& key) {
         const size_t hash = _hFunc(key);
 
         _items[hash] = ItemT{};
-        _occupancyTable[_hFunc(key)] = false;
+        _occupancyTable.reset(hash);
     }
 
     [[nodiscard]] size_t getSize() const {
         return _size;
     }
 
+    [[nodiscard]] const HashFuncT& getHashFunc() const {
+        return _hFunc;
+    }
+
     // Should only be used after successful SearchAndSaveOperation
     [[nodiscard]] ItemT& getLastSearched() {
         return *_lastSearch;
@@ -91,8 +197,8 @@ public:
     // ------------------------------
 protected:
 
-    std::vector<ItemT> _items;
-    std::vector<bool> _occupancyTable;
+    ItemStorageT<ItemT> _items;
+    OccupancyBitmap _occupancyTable;
     size_t _size;
     HashFuncT _hFunc;
 
@@ -130,11 +236,12 @@ public:
     using _basePlainMapT<KeyT, ItemT, HashFuncT>::operator[];
     using _basePlainMapT<KeyT, ItemT, HashFuncT>::remove;
     using _basePlainMapT<KeyT, ItemT, HashFuncT>::getSize;
+    using _basePlainMapT<KeyT, ItemT, HashFuncT>::getHashFunc;
 
     bool insert(const KeyT& key, const ItemT& item) {
         if (const size_t hash = _hFunc(key); !_occupancyTable[hash]) {
             _items[hash] = item;
-            _occupancyTable[hash] = true;
+            _occupancyTable.set(hash);
             _keys[hash] = key;
 
             return true;
@@ -155,7 +262,7 @@ public:
         const size_t hash = hashFunc(key);
 
         _items[hash] = ItemT{};
-        _occupancyTable[hashFunc(key)] = false;
+        _occupancyTable.reset(hash);
         _keys[hash] = KeyT{};
     }
 
@@ -175,47 +282,42 @@ public:
         HashFuncT hashFunc(nSize);
 
         // prepare containers
-        std::vector<ItemT> nItems(nSize);
-        std::vector<bool> nOccup(nSize);
+        ItemStorageT<ItemT> nItems(nSize);
+        OccupancyBitmap nOccup(nSize);
         std::vector<KeyT> nKeys(nSize);
 
         do {
-            collisionDetected = false;
-
-            // copy all existing elements
-            for (size_t i = 0; i < _items.size(); ++i) {
-                if (_occupancyTable[i] == false) continue;
-
+            // copy all existing elements, empty words of the bitmap are skipped
+            collisionDetected = !_occupancyTable.allOfSet([&](const size_t i) {
                 const size_t hash = hashFunc(_keys[i]);
 
                 // collision detected abort
-                if (nOccup[hash] == true) {
-                    nOccup.assign(nSize, false);
-                    collisionDetected = true;
-                    hashFunc = HashFuncT(nSize);
-                    break;
-                }
+                if (nOccup[hash]) return false;
 
                 nItems[hash] = _items[i];
-                nOccup[hash] = true;
+                nOccup.set(hash);
                 nKeys[hash] = _keys[i];
-            }
+                return true;
+            });
 
+            if (collisionDetected) {
+                nOccup.clear();
+                hashFunc = HashFuncT(nSize);
+            }
         }while(collisionDetected);
 
-
         _size = nSize;
         _hFunc = hashFunc;
-        _keys = nKeys;
-        _items = nItems;
-        _occupancyTable = nOccup;
+        _keys = std::move(nKeys);
+        _items = std::move(nItems);
+        _occupancyTable = std::move(nOccup);
     }
 
     [[nodiscard]] const KeyT& getLastSearchedKey() const {
         return *_lastSearchedKey;
     }
 
-    [[nodiscard]] std::tuple<const std::vector<KeyT>&, const std::vector<ItemT>&, const std::vector<bool>&> getUnderlyingArrays() const {
+    [[nodiscard]] std::tuple<const std::vector<KeyT>&, const ItemStorageT<ItemT>&, const OccupancyBitmap&> getUnderlyingArrays() const {
         return { _keys, _items, _occupancyTable };
     }
 
@@ -230,32 +332,31 @@ private:
         HashFuncT hashFunc(nSize);
 
         // prepare containers
-        std::vector<ItemT> nItems(nSize);
-        std::vector<bool> nOccup(nSize);
+        ItemStorageT<ItemT> nItems(nSize);
+        OccupancyBitmap nOccup(nSize);
         std::vector<KeyT> nKeys(nSize);
 
-        // copy all existing elements
-        for (size_t i = 0; i < _items.size(); ++i) {
-            if (_occupancyTable[i] == false) continue;
-
+        // copy all existing elements, empty words of the bitmap are skipped
+        const bool transferred = _occupancyTable.allOfSet([&](const size_t i) {
             const size_t hash = hashFunc(_keys[i]);
 
             // collision detected abort
-            if (nOccup[hash] == true) {
-                return false;
-            }
+            if (nOccup[hash]) return false;
 
             nItems[hash] = _items[i];
-            nOccup[hash] = true;
+            nOccup.set(hash);
             nKeys[hash] = _keys[i];
-        }
+            return true;
+        });
 
-        // setup new parameters
+        if (!transferred) return false;
+
+        // setup new parameters, moved so table shrunk by resize releases its old memory
         _size = nSize;
         _hFunc = hashFunc;
-        _keys = nKeys;
-        _items = nItems;
-        _occupancyTable = nOccup;
+        _keys = std::move(nKeys);
+        _items = std::move(nItems);
+        _occupancyTable = std::move(nOccup);
 
         return true;
     }
@@ -274,4 +375,10 @@ private:
     using _basePlainMapT<KeyT, ItemT, HashFuncT>::_lastSearch;
 };
 
+// Key-only variant, items are passed as EmptyItem{} and occupy no memory
+template<
+    class KeyT,
+    class HashFuncT = BaseHashFunction<KeyT>
+>using _baseExpandiblePlainSetT = _baseExpandiblePlainMapT<KeyT, EmptyItem, HashFuncT>;
+
 #endif //PLAINHASHMAP_H
@@ -0,0 +1,153 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef SPACESAVING_H
+#define SPACESAVING_H
+
+#include "chainHashingMap.h"
+#include "../Heaps/_indexedHeapT.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+template<
+    class KeyT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, size_t, ComparerT>
+>class _spaceSavingT {
+    /*                  Description
+     *  Space-Saving heavy hitters tracker (Metwally et al.) - keeps at most capacity counters over the stream.
+     *  Key, which is already tracked, increments its counter. Untracked key takes over counter with the minimal
+     *  count: count is incremented and previous value is remembered as maximal overestimation (error) of the key.
+     *
+     *  Guarantees: every key with real frequency above streamLength / capacity is tracked and for every tracked key
+     *  count - error <= real frequency <= count.
+     *
+     *  Keys and errors live in flat arrays indexed by slot. Chain map translates key into slot, while counts are
+     *  kept in _indexedHeapT min-heap holding slots, so handle of the slot changes its count in place. Both increment
+     *  and takeover cost O(log capacity) and the map, reserved to the capacity upfront, never rehashes.
+     */
+
+    // ------------------------------
+    // Inner types
+    // ------------------------------
+public:
+
+    struct HeavyHitter {
+        KeyT key;
+        size_t count;
+        size_t error;
+    };
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+
+    // Note: throws std::runtime_error when capacity is 0
+    explicit _spaceSavingT(const size_t capacity):
+        _keys(capacity), _errors(capacity), _handles(capacity)
+    {
+        if (capacity == 0)
+            throw std::runtime_error("[ ERROR ] Space-Saving capacity has to be positive.");
+
+        _slots.reserve(capacity);
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    void add(const KeyT& key, const size_t weight = 1) {
+        _streamLength += weight;
+
+        if (const size_t* slot = _slots.find(key)) {
+            const HeapHandle handle = _handles[*slot];
+            _heap.IncreaseKey(handle, _heap.GetPriority(handle) + weight);
+            return;
+        }
+
+        if (_size < _keys.size()) {
+            const size_t slot = _size++;
+
+            _keys[slot] = key;
+            _errors[slot] = 0;
+            _slots.insert(key, slot);
+            _handles[slot] = _heap.Insert({ weight, slot });
+            return;
+        }
+
+        // taking over the counter with minimal count
+        const auto [count, slot] = _heap.Max();
+        _slots.remove(_keys[slot]);
+
+        _keys[slot] = key;
+        _errors[slot] = count;
+        _slots.insert(key, slot);
+
+        _heap.IncreaseKey(_handles[slot], count + weight);
+    }
+
+    // Returns upper bound of key frequency - count of tracked key or minimal count otherwise
+    [[nodiscard]] size_t estimate(const KeyT& key) const {
+        if (const size_t* slot = _slots.find(key)) return _heap.GetPriority(_handles[*slot]);
+        return getMinCount();
+    }
+
+    [[nodiscard]] bool isTracked(const KeyT& key) const {
+        return _slots.search(key);
+    }
+
+    // Returns k tracked keys with highest counts, sorted descending by count
+    [[nodiscard]] std::vector<HeavyHitter> getTopK(const size_t k) const {
+        std::vector<HeavyHitter> result{};
+        result.reserve(_size);
+
+        for (size_t slot = 0; slot < _size; ++slot)
+            result.push_back({ _keys[slot], _heap.GetPriority(_handles[slot]), _errors[slot] });
+
+        const size_t count = std::min(k, result.size());
+        std::partial_sort(result.begin(), result.begin() + count, result.end(),
+            [](const HeavyHitter& a, const HeavyHitter& b) { return a.count > b.count; });
+        result.resize(count);
+
+        return result;
+    }
+
+    // Returns minimal tracked count, 0 until all counters are used
+    [[nodiscard]] size_t getMinCount() const {
+        return _size < _keys.size() ? 0 : _heap.Max().first;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _size;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return _keys.size();
+    }
+
+    [[nodiscard]] size_t getStreamLength() const {
+        return _streamLength;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+private:
+    std::vector<KeyT> _keys;
+    std::vector<size_t> _errors;
+    std::vector<HeapHandle> _handles; // heap element of every slot, its priority is the count
+
+    _indexedHeapT<size_t, size_t, std::less<>, 0> _heap{}; // slots ordered by count
+
+    _chainHashingMapT<KeyT, size_t, ComparerT, HashFuncT, BucketT> _slots{};
+
+    size_t _size{};
+    size_t _streamLength{};
+};
+
+#endif //SPACESAVING_H
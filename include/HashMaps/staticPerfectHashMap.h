@@ -0,0 +1,285 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef STATICPERFECTHASHMAP_H
+#define STATICPERFECTHASHMAP_H
+
+#include "HashFunctions.h"
+#include "perfectHashHelpers.h"
+#include "../parallelHelpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+template<
+    class KeyT,
+    class ItemT,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>
+>class _staticPerfectHashMapT {
+    /*                  Description
+     *  Read-only dictionary built once over known key set with minimal perfect hash function.
+     *  Function is constructed with bucket-and-displace method (CHD/PTHash-like):
+     *
+     *  - keys are split into independent partitions of ~PartitionSize keys, which are built in parallel,
+     *  - inside partition single hash h(x) is evaluated, its high bits distribute keys into buckets
+     *    of ~AverageBucketSize keys,
+     *  - buckets are processed from the biggest one and for each bucket pilot value is searched, such that
+     *      pos(x) = (h(x) ^ mix(pilot)) mod slotCount
+     *    places all keys of the bucket in free slots,
+     *  - slotCount is slightly bigger than key count (LoadFactor), which makes search for the last buckets cheap,
+     *    keys placed behind key count are remapped to the free slots with small remap table.
+     *
+     *  Thus lookup evaluates two hash functions and does single probe followed by key verification.
+     *  Hash function alone costs about 16 / AverageBucketSize bits per key for pilots plus few bits for the remap table.
+     *
+     *  Note: HashFuncT is constructed only with power of 2 sizes.
+     */
+
+    // ------------------------------
+    // Inner types
+    // ------------------------------
+
+    struct partition {
+        HashFuncT positionHash;
+        size_t keyOffset; // partition keys are stored inside [keyOffset, keyOffset + keyCount)
+        size_t keyCount;
+        size_t slotCount;
+        size_t pilotOffset;
+        size_t bucketCount;
+        size_t remapOffset; // remap table has slotCount - keyCount entries
+    };
+
+    using pilotT = perfectHashPilotT;
+    using remapT = uint32_t;
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // Note: keys have to be distinct, otherwise std::runtime_error is thrown after exceeding MaxSeedTries
+    _staticPerfectHashMapT(const std::vector<KeyT>& keys, const std::vector<ItemT>& items,
+                           const size_t threadCount = getDefaultThreadCount()):
+        _partitionHash{_getPartitionCount(keys.size())},
+        _keys(keys.size()), _items(keys.size())
+    {
+        if (keys.size() != items.size())
+            throw std::runtime_error("[ ERROR ] Passed keys and items have different sizes.");
+
+        if (keys.size() > POW2FAST(sizeof(remapT) * 8))
+            throw std::runtime_error("[ ERROR ] Too many keys passed to _staticPerfectHashMapT.");
+
+        _build(keys, items, threadCount);
+    }
+
+    _staticPerfectHashMapT(const _staticPerfectHashMapT&) = default;
+    _staticPerfectHashMapT(_staticPerfectHashMapT&&) = default;
+    _staticPerfectHashMapT& operator=(const _staticPerfectHashMapT&) = default;
+    _staticPerfectHashMapT& operator=(_staticPerfectHashMapT&&) = default;
+
+    ~_staticPerfectHashMapT() = default;
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Returns pointer to the item stored under the key or nullptr if key is not present
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        const size_t index = _getIndex(key);
+        return index == NotFound ? nullptr : &_items[index];
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        const size_t index = _getIndex(key);
+        return index == NotFound ? nullptr : &_items[index];
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return _getIndex(key) != NotFound;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    [[nodiscard]] ItemT& get(const KeyT& key) {
+        return *find(key);
+    }
+
+    [[nodiscard]] const ItemT& get(const KeyT& key) const {
+        return *find(key);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _keys.size();
+    }
+
+    // Returns memory used by the hash function itself, without keys and items, per single key
+    [[nodiscard]] double getHashBitsPerKey() const {
+        const size_t bytes = _pilots.size() * sizeof(pilotT) + _remap.size() * sizeof(remapT)
+            + _partitions.size() * sizeof(partition) + sizeof(HashFuncT);
+
+        return _keys.empty() ? 0.0 : 8.0 * bytes / _keys.size();
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] size_t _getIndex(const KeyT& key) const {
+        const partition& part = _partitions[_partitionHash(key)];
+        if (part.keyCount == 0) return NotFound;
+
+        const size_t hash = part.positionHash(key);
+        size_t pos = _getPosition(hash, _pilots[part.pilotOffset + _getBucket(hash, part.bucketCount)], part.slotCount);
+
+        if (pos >= part.keyCount) pos = _remap[part.remapOffset + pos - part.keyCount];
+
+        const size_t index = part.keyOffset + pos;
+        return _comp(_keys[index], key) ? index : NotFound;
+    }
+
+    static size_t _getPartitionCount(const size_t keyCount) {
+        return ceilPow2((keyCount + PartitionSize - 1) / PartitionSize);
+    }
+
+    // Maps high 32 bits of the hash into range [0, bucketCount) without division
+    static size_t _getBucket(const size_t hash, const size_t bucketCount) {
+        return ((hash >> (PositionHashBits - 32)) * bucketCount) >> 32;
+    }
+
+    static size_t _getPosition(const size_t hash, const pilotT pilot, const size_t slotCount) {
+        return (hash ^ mixPerfectHashPilot(pilot)) % slotCount;
+    }
+
+    void _build(const std::vector<KeyT>& keys, const std::vector<ItemT>& items, const size_t threadCount) {
+        const size_t partitionCount = _getPartitionCount(keys.size());
+
+        // distributing key indexes into partitions - counting sort
+        std::vector<size_t> partitionStart(partitionCount + 1);
+        std::vector<size_t> partitionOf(keys.size());
+
+        for (size_t i = 0; i < keys.size(); ++i)
+            ++partitionStart[(partitionOf[i] = _partitionHash(keys[i])) + 1];
+
+        for (size_t i = 0; i < partitionCount; ++i)
+            partitionStart[i + 1] += partitionStart[i];
+
+        std::vector<size_t> order(keys.size());
+        std::vector<size_t> fill(partitionStart.begin(), partitionStart.end() - 1);
+        for (size_t i = 0; i < keys.size(); ++i)
+            order[fill[partitionOf[i]]++] = i;
+
+        // all partition sizes are known, so every partition gets its own disjoint ranges of shared tables
+        _partitions.reserve(partitionCount);
+        size_t pilotCount{};
+        size_t remapCount{};
+
+        for (size_t i = 0; i < partitionCount; ++i) {
+            const size_t keyCount = partitionStart[i + 1] - partitionStart[i];
+            const size_t slotCount = std::max(keyCount, static_cast<size_t>(std::ceil(keyCount / LoadFactor)));
+            const size_t bucketCount = std::max<size_t>(1, (keyCount + AverageBucketSize - 1) / AverageBucketSize);
+
+            _partitions.push_back(partition{
+                HashFuncT(PositionHashRange),
+                partitionStart[i], keyCount, slotCount, pilotCount, bucketCount, remapCount
+            });
+
+            pilotCount += bucketCount;
+            remapCount += slotCount - keyCount;
+        }
+
+        _pilots.resize(pilotCount);
+        _remap.resize(remapCount);
+
+        std::atomic<bool> failed{false};
+        parallelForEachTask(partitionCount, threadCount, [&](const size_t part) {
+            if (!_buildPartition(_partitions[part], keys, items, order.data() + partitionStart[part]))
+                failed = true;
+        });
+
+        if (failed)
+            throw std::runtime_error("[ ERROR ] Unable to build perfect hash function, passed keys are probably not distinct.");
+    }
+
+    bool _buildPartition(partition& part, const std::vector<KeyT>& keys, const std::vector<ItemT>& items, const size_t* keyIndexes) {
+        const size_t n = part.keyCount;
+        if (n == 0) return true;
+
+        std::vector<size_t> hashes(n); // indexed like keyIndexes
+        std::vector<bool> taken(part.slotCount);
+        PerfectHashBuckets buckets{};
+
+        for (int tries = 0; tries < MaxSeedTries; ++tries) {
+            if (tries != 0) part.positionHash.RollParameteres();
+
+            for (size_t i = 0; i < n; ++i)
+                hashes[i] = part.positionHash(keys[keyIndexes[i]]);
+            buckets.group(n, part.bucketCount, [&](const size_t i) { return _getBucket(hashes[i], part.bucketCount); });
+
+            taken.assign(part.slotCount, false);
+            const bool placed = buckets.place(
+                [&](const size_t i, const pilotT pilot) { return _getPosition(hashes[i], pilot, part.slotCount); },
+                taken,
+                [&](const size_t bucket, const pilotT pilot) { _pilots[part.pilotOffset + bucket] = pilot; });
+
+            if (placed) {
+                _fillPartition(part, keys, items, keyIndexes, hashes, taken);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void _fillPartition(const partition& part, const std::vector<KeyT>& keys, const std::vector<ItemT>& items,
+                        const size_t* keyIndexes, const std::vector<size_t>& hashes, const std::vector<bool>& taken) {
+        // slots behind key count are remapped to free slots in front of it
+        size_t freeSlot = 0;
+        for (size_t pos = part.keyCount; pos < part.slotCount; ++pos) {
+            if (!taken[pos]) continue;
+
+            while (taken[freeSlot]) ++freeSlot;
+            _remap[part.remapOffset + pos - part.keyCount] = static_cast<remapT>(freeSlot++);
+        }
+
+        for (size_t i = 0; i < part.keyCount; ++i) {
+            const size_t hash = hashes[i];
+
+            size_t pos = _getPosition(hash, _pilots[part.pilotOffset + _getBucket(hash, part.bucketCount)], part.slotCount);
+            if (pos >= part.keyCount) pos = _remap[part.remapOffset + pos - part.keyCount];
+
+            _keys[part.keyOffset + pos] = keys[keyIndexes[i]];
+            _items[part.keyOffset + pos] = items[keyIndexes[i]];
+        }
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t PartitionSize = POW2FAST(16);
+    static constexpr size_t AverageBucketSize = 5;
+    static constexpr double LoadFactor = 0.99;
+    static constexpr int MaxSeedTries = 16;
+    static constexpr int PositionHashBits = 48;
+    static constexpr size_t PositionHashRange = POW2FAST(PositionHashBits);
+    static constexpr size_t NotFound = SIZE_MAX;
+private:
+    HashFuncT _partitionHash;
+
+    std::vector<partition> _partitions{};
+    std::vector<pilotT> _pilots{};
+    std::vector<remapT> _remap{};
+
+    std::vector<KeyT> _keys;
+    std::vector<ItemT> _items;
+
+    inline static ComparerT _comp{};
+};
+
+#endif //STATICPERFECTHASHMAP_H
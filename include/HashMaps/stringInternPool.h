@@ -0,0 +1,242 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef STRINGINTERNPOOL_H
+#define STRINGINTERNPOOL_H
+
+#include "chainHashingMap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+struct InternedString {
+    /*                  Description
+     *  Handle of the string stored inside StringInternPool. Handles of the same pool are equal
+     *  only for equal strings, so maps keyed by handles compare 32-bit ids instead of string bytes.
+     *  Hash functions from HashFunctions.h use internedStringId as HashableAccessor, so they hash the id
+     *  and never touch the string - see InternedMapT.
+     */
+
+    uint32_t id = InvalidId;
+
+    [[nodiscard]] bool isValid() const {
+        return id != InvalidId;
+    }
+
+    bool operator==(const InternedString&) const = default;
+
+    static constexpr uint32_t InvalidId = UINT32_MAX;
+};
+
+inline size_t internedStringId(const InternedString& str) {
+    return str.id;
+}
+
+class StringInternPool {
+    /*                  Description
+     *  Stores every distinct string once. Bytes are appended to arena built from chunks of ChunkSize bytes
+     *  (longer strings get chunk of their own), so views returned by the pool stay valid for its whole life.
+     *  Every entry keeps pointer, length and hash of its string (FNV-1a mixed with 64-bit finalizer).
+     *
+     *  Index is open addressing table with linear probing, every slot holds id together with upper 32 bits
+     *  of the hash, so probing compares bytes only when both tags match. Index grows when it is half full
+     *  and its rehash uses only cached hashes - string bytes are never read again.
+     *
+     *  Note: handles of different pools must not be mixed.
+     */
+
+    struct entry {
+        const char* data;
+        size_t length;
+        size_t hash;
+    };
+
+    struct slot {
+        uint32_t id;
+        uint32_t tag;
+    };
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    StringInternPool() {
+        _slots.assign(MinSlotCount, slot{ InternedString::InvalidId, 0 });
+    }
+
+    StringInternPool(const StringInternPool&) = delete;
+    StringInternPool& operator=(const StringInternPool&) = delete;
+
+    StringInternPool(StringInternPool&&) = default;
+    StringInternPool& operator=(StringInternPool&&) = default;
+
+    ~StringInternPool() = default;
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    // Returns handle of the string, string is copied into the pool on its first occurrence.
+    // Note: throws std::runtime_error when pool exceeds 2^32 - 1 distinct strings
+    InternedString intern(const std::string_view str) {
+        const size_t hash = _getHash(str);
+        const size_t pos = _lookupSlot(str, hash);
+
+        if (_slots[pos].id != InternedString::InvalidId) return InternedString{ _slots[pos].id };
+
+        if (_entries.size() >= InternedString::InvalidId)
+            throw std::runtime_error("[ ERROR ] String intern pool exceeded maximal number of strings.");
+
+        const auto id = static_cast<uint32_t>(_entries.size());
+        _entries.push_back(entry{ _store(str), str.size(), hash });
+        _slots[pos] = slot{ id, _getTag(hash) };
+
+        // at most half of the slots is used, so probing sequences stay short
+        if (_entries.size() * 2 > _slots.size()) _grow();
+
+        return InternedString{ id };
+    }
+
+    // Returns handle of already interned string, the pool is not modified
+    [[nodiscard]] std::optional<InternedString> find(const std::string_view str) const {
+        const uint32_t id = _slots[_lookupSlot(str, _getHash(str))].id;
+        if (id == InternedString::InvalidId) return std::nullopt;
+
+        return InternedString{ id };
+    }
+
+    [[nodiscard]] bool contains(const std::string_view str) const {
+        return find(str).has_value();
+    }
+
+    // Note: handle MUST come from this pool, otherwise behavior is undefined
+    [[nodiscard]] std::string_view view(const InternedString str) const {
+        const entry& e = _entries[str.id];
+        return { e.data, e.length };
+    }
+
+    // Returns cached hash of the string - the same for equal strings of any pool
+    [[nodiscard]] size_t hash(const InternedString str) const {
+        return _entries[str.id].hash;
+    }
+
+    [[nodiscard]] size_t length(const InternedString str) const {
+        return _entries[str.id].length;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _entries.size();
+    }
+
+    // Returns number of bytes allocated for the arena, used or not
+    [[nodiscard]] size_t getArenaBytes() const {
+        return _arenaBytes;
+    }
+
+    [[nodiscard]] size_t getSlotCount() const {
+        return _slots.size();
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    static size_t _getHash(const std::string_view str) {
+        return mixHash64(fnv1aHash(str));
+    }
+
+    static uint32_t _getTag(const size_t hash) {
+        return static_cast<uint32_t>(hash >> 32);
+    }
+
+    // Returns slot holding the string or empty slot, where it should be placed
+    [[nodiscard]] size_t _lookupSlot(const std::string_view str, const size_t hash) const {
+        const size_t mask = _slots.size() - 1;
+        const uint32_t tag = _getTag(hash);
+
+        for (size_t pos = hash & mask; ; pos = (pos + 1) & mask) {
+            const slot& s = _slots[pos];
+            if (s.id == InternedString::InvalidId) return pos;
+            if (s.tag != tag) continue;
+
+            const entry& e = _entries[s.id];
+            if (e.hash == hash && std::string_view(e.data, e.length) == str) return pos;
+        }
+    }
+
+    void _grow() {
+        std::vector<slot> nSlots(_slots.size() * 2, slot{ InternedString::InvalidId, 0 });
+        const size_t mask = nSlots.size() - 1;
+
+        for (const slot& s : _slots) {
+            if (s.id == InternedString::InvalidId) continue;
+
+            size_t pos = _entries[s.id].hash & mask;
+            while (nSlots[pos].id != InternedString::InvalidId) pos = (pos + 1) & mask;
+            nSlots[pos] = s;
+        }
+
+        _slots = std::move(nSlots);
+    }
+
+    // copies bytes of the string to the arena, chunks are never reallocated
+    const char* _store(const std::string_view str) {
+        // oversized string gets chunk of its own, so free space of the actual chunk is kept for next strings
+        if (str.size() > ChunkSize) {
+            _chunks.push_back(std::make_unique_for_overwrite<char[]>(str.size()));
+            _arenaBytes += str.size();
+
+            std::memcpy(_chunks.back().get(), str.data(), str.size());
+            return _chunks.back().get();
+        }
+
+        if (str.size() > _chunkFree) {
+            _chunks.push_back(std::make_unique_for_overwrite<char[]>(ChunkSize));
+            _arenaBytes += ChunkSize;
+
+            _chunkPos = _chunks.back().get();
+            _chunkFree = ChunkSize;
+        }
+
+        char* dst = _chunkPos;
+        if (!str.empty()) std::memcpy(dst, str.data(), str.size());
+
+        _chunkPos += str.size();
+        _chunkFree -= str.size();
+
+        return dst;
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t ChunkSize = 64 * 1024;
+    static constexpr size_t MinSlotCount = 16;
+private:
+    std::vector<entry> _entries{};
+    std::vector<slot> _slots{};
+
+    std::vector<std::unique_ptr<char[]>> _chunks{};
+    char* _chunkPos{}; // first free byte of the actual chunk
+    size_t _chunkFree{};
+    size_t _arenaBytes{};
+};
+
+// Chain map keyed by handles of single StringInternPool, both outer and inner hash functions hash ids only
+template<
+    class ItemT,
+    class HashFuncT = BaseHashFunction<InternedString, true, internedStringId>
+>using InternedMapT = _chainHashingMapT<InternedString, ItemT, std::equal_to<InternedString>, HashFuncT,
+    PlainHashBucketT<InternedString, ItemT, std::equal_to<InternedString>, HashFuncT>>;
+
+#endif //STRINGINTERNPOOL_H
@@ -0,0 +1,248 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef VALUELOGMAP_H
+#define VALUELOGMAP_H
+
+#include "chainHashingMap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template<
+    class KeyT,
+    class ItemT,
+    class OffsetT = uint32_t,
+    class ComparerT = std::equal_to<KeyT>,
+    class HashFuncT = BaseHashFunction<KeyT, true>,
+    class BucketT = PlainHashBucketT<KeyT, OffsetT, ComparerT>
+>class _valueLogMapT {
+    /*                  Description
+     *  Map with key/value separation, designed for large items. Items are appended to value log
+     *  built from fixed size chunks (so appending never moves already written items), while chain map
+     *  holds only keys and offsets of their items inside the log. Rehash of the map moves keys and offsets only
+     *  and buckets keep much more keys per cache line.
+     *
+     *  Overwriting or removing the key leaves its previous item in the log as dead one. Every log entry holds
+     *  also its key, so compaction recognizes live entries by comparing their offsets with offsets found in the map.
+     *  Live items are rewritten in log order to the new log and dead ones are dropped.
+     *  Compaction is performed automatically, when dead items take more than MaxDeadFraction of the log.
+     *
+     *  Note: pointers to items are invalidated by compaction - by any assign, remove or explicit compact() call.
+     */
+
+    struct entry {
+        KeyT key;
+        ItemT item;
+    };
+
+    using _mapT = _chainHashingMapT<KeyT, OffsetT, ComparerT, HashFuncT, BucketT>;
+
+    static_assert(std::is_unsigned_v<OffsetT>, "Offset has to be unsigned integer type");
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    _valueLogMapT() = default;
+    explicit _valueLogMapT(const size_t size): _map(size) {}
+
+    _valueLogMapT(const _valueLogMapT& other):
+        _map(other._map), _deadCount(other._deadCount), _logSize(other._logSize), _compactionCount(other._compactionCount)
+    {
+        _chunks.reserve(other._chunks.size());
+
+        for (const auto& chunk : other._chunks) {
+            _chunks.push_back(std::make_unique<entry[]>(ChunkEntries));
+            std::copy(chunk.get(), chunk.get() + ChunkEntries, _chunks.back().get());
+        }
+    }
+
+    _valueLogMapT(_valueLogMapT&&) = default;
+
+    _valueLogMapT& operator=(const _valueLogMapT& other) {
+        if (&other != this) *this = _valueLogMapT(other);
+        return *this;
+    }
+
+    _valueLogMapT& operator=(_valueLogMapT&&) = default;
+
+    ~_valueLogMapT() = default;
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    bool insert(std::pair<KeyT, ItemT> pair) {
+        const auto& [key, item] = pair;
+        return insert(key, item);
+    }
+
+    // Returns false and leaves actual item untouched, when key is already present
+    // Note: throws std::runtime_error, when log exceeds range of OffsetT
+    bool insert(const KeyT& key, const ItemT& item) {
+        if (_map.search(key)) return false;
+
+        _map.insert(key, _append(key, item));
+        return true;
+    }
+
+    // Inserts the key or replaces its item, previous item becomes dead
+    void assign(const KeyT& key, const ItemT& item) {
+        if (OffsetT* offset = _map.find(key)) {
+            *offset = _append(key, item);
+            ++_deadCount;
+            _compactIfNeeded();
+            return;
+        }
+
+        _map.insert(key, _append(key, item));
+    }
+
+    [[nodiscard]] bool search(const KeyT& key) const {
+        return _map.search(key);
+    }
+
+    [[nodiscard]] const ItemT* find(const KeyT& key) const {
+        const OffsetT* offset = _map.find(key);
+        return offset ? &_getEntry(*offset).item : nullptr;
+    }
+
+    [[nodiscard]] ItemT* find(const KeyT& key) {
+        const OffsetT* offset = _map.find(key);
+        return offset ? &_getEntry(*offset).item : nullptr;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    [[nodiscard]] ItemT& get(const KeyT& key) {
+        return _getEntry(_map.get(key)).item;
+    }
+
+    [[nodiscard]] ItemT& operator[](const KeyT& key) {
+        if (ItemT* item = find(key)) return *item;
+
+        const OffsetT offset = _append(key, ItemT{});
+        _map.insert(key, offset);
+        return _getEntry(offset).item;
+    }
+
+    // Note: element MUST be contained, otherwise behavior is undefined
+    void remove(const KeyT& key) {
+        _map.remove(key);
+        ++_deadCount;
+        _compactIfNeeded();
+    }
+
+    bool safeRemove(const KeyT& key) {
+        if (!_map.safeRemove(key)) return false;
+
+        ++_deadCount;
+        _compactIfNeeded();
+        return true;
+    }
+
+    // Rewrites live items into new log, dropping all dead ones
+    void compact() {
+        std::vector<std::unique_ptr<entry[]>> oldChunks = std::move(_chunks);
+        const size_t oldSize = _logSize;
+
+        _chunks.clear();
+        _logSize = 0;
+        _deadCount = 0;
+        ++_compactionCount;
+
+        for (size_t offset = 0; offset < oldSize; ++offset) {
+            entry& oEntry = oldChunks[offset / ChunkEntries][offset % ChunkEntries];
+
+            // entry is live only when map still points to it
+            if (OffsetT* mapped = _map.find(oEntry.key); mapped && *mapped == offset)
+                *mapped = _append(oEntry.key, std::move(oEntry.item));
+
+            // chunk is released as soon as all its entries are moved
+            if (offset % ChunkEntries == ChunkEntries - 1) oldChunks[offset / ChunkEntries].reset();
+        }
+    }
+
+    void reserve(const size_t elemCount) {
+        _map.reserve(elemCount);
+        _chunks.reserve((elemCount + ChunkEntries - 1) / ChunkEntries);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _map.size();
+    }
+
+    [[nodiscard]] float load_factor() const {
+        return _map.load_factor();
+    }
+
+    [[nodiscard]] size_t getRehashCount() const {
+        return _map.getRehashCount();
+    }
+
+    // Returns number of all items in the log - live and dead ones
+    [[nodiscard]] size_t getLogSize() const {
+        return _logSize;
+    }
+
+    [[nodiscard]] size_t getDeadCount() const {
+        return _deadCount;
+    }
+
+    [[nodiscard]] size_t getCompactionCount() const {
+        return _compactionCount;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    [[nodiscard]] entry& _getEntry(const size_t offset) const {
+        return _chunks[offset / ChunkEntries][offset % ChunkEntries];
+    }
+
+    template<class ItemArgT>
+    OffsetT _append(const KeyT& key, ItemArgT&& item) {
+        if (_logSize > std::numeric_limits<OffsetT>::max())
+            throw std::runtime_error("[ ERROR ] Value log exceeded range of the offset type.");
+
+        if (_logSize % ChunkEntries == 0) _chunks.push_back(std::make_unique<entry[]>(ChunkEntries));
+
+        entry& nEntry = _getEntry(_logSize);
+        nEntry.key = key;
+        nEntry.item = std::forward<ItemArgT>(item);
+
+        return static_cast<OffsetT>(_logSize++);
+    }
+
+    void _compactIfNeeded() {
+        if (_logSize >= MinCompactedLog && _deadCount > _logSize * MaxDeadFraction) compact();
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+public:
+    static constexpr size_t ChunkEntries = 1024;
+    static constexpr size_t MinCompactedLog = ChunkEntries;
+    static constexpr double MaxDeadFraction = 0.5;
+private:
+    _mapT _map{};
+
+    std::vector<std::unique_ptr<entry[]>> _chunks{};
+    size_t _deadCount{};
+    size_t _logSize{};
+    size_t _compactionCount{};
+};
+
+#endif //VALUELOGMAP_H
@@ -6,9 +6,13 @@
 #define ARRAYBASEDSTRUCTURE_H
 
 #include <cstring>
+#include <algorithm>
 #include <cmath>
 #include <exception>
 #include <stdexcept>
+#include <memory>
+#include <new>
+#include <utility>
 
 /*              TODOS:
  *  - rethink all operator[] methods
@@ -39,12 +43,17 @@ public:
     static constexpr size_t InitalSize { 128 };
 };
 
-template<typename T, bool IsMemSafe>
+template<typename T, bool IsMemSafe, size_t Alignment = alignof(T)>
 class TArrayBasedStructure: public ArrayBasedStructure
     /*  Defines all usefull operations on arrays to prevent multiplying code across all arraybased structures
      *  Does all necessary memory management needed in such structures.
+     *  Base array is aligned to Alignment bytes, e.g. to cache line, so derived structures may place
+     *  groups of elements at cache line boundaries.
      */
 {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+        "Alignment has to be power of 2 not smaller than alignment of the type");
+
 protected:
     // ------------------------------
     // Type creation/copying
@@ -52,7 +61,7 @@ protected:
 
     // Basic construction procedure. That is pointers are null valued and uses inital array length: 128.
     TArrayBasedStructure() {
-        Array = new T[InitalSize];
+        Array = _allocate(InitalSize);
     }
 
     // Configurable construction. Allocates base array with length of desiredCount and pastes mem into array,
@@ -73,56 +82,73 @@ protected:
                 throw std::runtime_error("[ ERROR ] Passed mem chunk to TArrayBasedStructure is null.");
         }
 
-        Array = new T[desiredCount];
+        Array = _allocate(desiredCount);
         memcpy(Array + cpyStartIndex, mem, memCount*sizeof(T));
     }
 
     // Created fundational array with passed initial size.
     explicit TArrayBasedStructure(const size_t initSize): ArrayBasedStructure(initSize, 0) {
-        Array = new T[initSize];
+        Array = _allocate(initSize);
     }
 
     // Simplified version of above one. Just uses copy of passed memory as initializing array.
     TArrayBasedStructure(const T* mem, const size_t elemCount): TArrayBasedStructure(mem, elemCount, elemCount, 0) {}
 
+    // templated constructors are never copy/move constructors, so implicit shallow ones have to be replaced
+    TArrayBasedStructure(const TArrayBasedStructure& other):
+        TArrayBasedStructure(other.Array, other.EndP, other.ElemCount, 0) {}
+
+    TArrayBasedStructure(TArrayBasedStructure&& other) noexcept(true):
+        ArrayBasedStructure{ other.ElemCount, other.EndP }, Array{ other.Array } {
+        other.Array = nullptr;
+    }
+
     template<bool memSafeCheck>
-    TArrayBasedStructure(const TArrayBasedStructure<T, memSafeCheck>& other):
+    TArrayBasedStructure(const TArrayBasedStructure<T, memSafeCheck, Alignment>& other):
         TArrayBasedStructure(other.Array, other.EndP, other.ElemCount, 0) {}
 
     template<bool memSafeCheck>
-    TArrayBasedStructure(TArrayBasedStructure<T, memSafeCheck>&& other) noexcept(true):
+    TArrayBasedStructure(TArrayBasedStructure<T, memSafeCheck, Alignment>&& other) noexcept(true):
         ArrayBasedStructure{ other.ElemCount, other.EndP }, Array{ other.Array } {
         other.Array = nullptr;
     }
 
 public:
+    TArrayBasedStructure& operator=(const TArrayBasedStructure& other) {
+        return operator=<IsMemSafe>(other);
+    }
+
+    TArrayBasedStructure& operator=(TArrayBasedStructure&& other) noexcept(true) {
+        return operator=<IsMemSafe>(std::move(other));
+    }
+
     template<bool memSafeCheck>
-    TArrayBasedStructure& operator=(const TArrayBasedStructure<T,memSafeCheck>& other) {
+    TArrayBasedStructure& operator=(const TArrayBasedStructure<T,memSafeCheck,Alignment>& other) {
         if (&other == this) return *this;
 
+        _deallocate(Array, ElemCount);
         ElemCount = other.ElemCount;
         EndP = other.EndP;
-        delete[] Array;
 
-        Array = new T[other.ElemCount];
+        Array = _allocate(other.ElemCount);
         memcpy(Array, other.Array, EndP*sizeof(T));
         return *this;
     }
 
     template<bool memSafeCheck>
-    TArrayBasedStructure& operator=(TArrayBasedStructure<T,memSafeCheck>&& other) noexcept(true) {
+    TArrayBasedStructure& operator=(TArrayBasedStructure<T,memSafeCheck,Alignment>&& other) noexcept(true) {
         if(&other == this) return *this;
 
+        _deallocate(Array, ElemCount);
         ElemCount = other.ElemCount;
         EndP = other.EndP;
-        delete[] Array;
         Array = other.Array;
         other.Array = nullptr;
         return *this;
     }
 
     ~TArrayBasedStructure() {
-        delete[] Array;
+        _deallocate(Array, ElemCount);
     }
 
 protected:
@@ -213,24 +239,50 @@ protected:
 private:
     void _expandArray() {
         const size_t oSize = ElemCount;
-        T* NewArray = new T[UpdateSize()];
+        T* NewArray = _allocate(UpdateSize());
 
         // TODO: find consensus here when no mem
 
         mempcpy(NewArray, Array, oSize * sizeof(T));
-        delete[] Array;
+        _deallocate(Array, oSize);
         Array = NewArray;
     }
 
     void _expandArray(const size_t newElemCount) {
+        const size_t oSize = ElemCount;
         ElemCount = newElemCount;
-        const T* arr = Array;
-        Array = new T[newElemCount];
+        T* arr = Array;
+        Array = _allocate(newElemCount);
 
         // TODO: find consensus here when no mem
 
-        memcpy(Array, arr, ElemCount * sizeof(T));
-        delete[] arr;
+        // only used part of the old array is copied, new one may be smaller
+        memcpy(Array, arr, std::min(EndP, newElemCount) * sizeof(T));
+        _deallocate(arr, oSize);
+    }
+
+    // over-aligned arrays need aligned operator new, which is not paired with plain delete[]
+    static T* _allocate(const size_t count) {
+        if constexpr (Alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return new T[count];
+        }
+        else {
+            T* mem = static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t{ Alignment }));
+            std::uninitialized_default_construct_n(mem, count);
+            return mem;
+        }
+    }
+
+    static void _deallocate(T* mem, const size_t count) {
+        if constexpr (Alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            delete[] mem;
+        }
+        else {
+            if (mem == nullptr) return;
+
+            std::destroy_n(mem, count);
+            ::operator delete[](mem, std::align_val_t{ Alignment });
+        }
     }
 
     T* Array = nullptr;
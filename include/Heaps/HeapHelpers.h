@@ -5,6 +5,8 @@
 #ifndef HEAPHELPERS_H
 #define HEAPHELPERS_H
 
+#include <cstddef>
+#include <cstdint>
 
 
 class HeapIndex
@@ -19,7 +21,7 @@ public:
     [[nodiscard]] size_t operator()() const { return index; }
     [[nodiscard]] bool isValid() const { return  index != 0; }
 private:
-    template<typename PrioT, typename ItemT, typename PriorityFunction, PrioT MostSignificantPrio>
+    template<typename PrioT, typename ItemT, typename PriorityFunction, PrioT MostSignificantPrio, size_t Arity>
     friend class _baseHeapT;
 
     template<typename PrioT, typename ItemT, typename PriorityFunction, PrioT MostSignificantPrio>
@@ -29,4 +31,21 @@ private:
     size_t index;
 };
 
+class HeapHandle
+    // Stable identifier of element inside _indexedHeapT. Contrary to HeapIndex it stays valid
+    // across all heap operations, until its element is removed. Afterwards the value may be
+    // reused by one of next inserted elements.
+{
+public:
+    HeapHandle(): handle{ InvalidHandle } {}
+    explicit HeapHandle(const uint32_t h): handle{ h } {}
+    [[nodiscard]] operator size_t() const { return handle; }
+    [[nodiscard]] bool isValid() const { return handle != InvalidHandle; }
+
+    // handles are 32-bit, so heap nodes stay small - the highest value is never given to any element
+    static constexpr uint32_t InvalidHandle = UINT32_MAX;
+private:
+    uint32_t handle;
+};
+
 #endif //HEAPHELPERS_H
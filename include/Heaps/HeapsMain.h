@@ -9,6 +9,7 @@
 
 #include "_baseBeapT.h"
 #include "_baseHeapT.h"
+#include "_indexedHeapT.h"
 #include "_baseLeftistHeapT.h"
 #include "_baseBinomialQueueT.h"
 #include "heapTesters.h"
@@ -17,6 +18,9 @@ static constexpr bool displayBeap = false;
 static constexpr bool displayHeap = false;
 static constexpr bool displayLeftistHeap = true;
 static constexpr bool displayBinomialQueue = false;
+static constexpr bool displayHeapArity = false;
+static constexpr bool displayHeapBatch = false;
+static constexpr bool displayIndexedHeap = false;
 
 inline int HeapsMain()
 {
@@ -46,6 +50,18 @@ inline int HeapsMain()
         HeapTest<_baseHeapT>();
     }
 
+    if constexpr (displayHeapArity) {
+        HeapArityTest<_baseHeapT>();
+    }
+
+    if constexpr (displayHeapBatch) {
+        HeapBatchTest<_baseHeapT>();
+    }
+
+    if constexpr (displayIndexedHeap) {
+        IndexedHeapTest<_indexedHeapT, _baseHeapT>();
+    }
+
     return EXIT_SUCCESS;
 }
 
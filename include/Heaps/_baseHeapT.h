@@ -7,44 +7,71 @@
 
 #include <string>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <bit>
 
 #include "ArrayBasedStructure.h"
 #include "HeapHelpers.h"
+#include "heapChildSelection.h"
 
 static constexpr bool IsMemSafe = false;
 
-template<typename PrioT, typename ItemT, typename PriorityFunction, PrioT MostSignificantPrio>
-class _baseHeapT: public TArrayBasedStructure<std::pair<PrioT, ItemT>, IsMemSafe> {
+template<typename PrioT, typename ItemT, typename PriorityFunction, PrioT MostSignificantPrio, size_t Arity = 2>
+class _baseHeapT: public TArrayBasedStructure<std::pair<PrioT, ItemT>, IsMemSafe, HeapCacheLineSize>, _dAryHeapLayout<Arity> {
+    /*                  Description
+     *  Implicit d-ary heap, where Arity is chosen at compile time (2, 4, 8 or 16). Wider nodes make the heap
+     *  log2(Arity) times shallower, so DeleteMax touches less levels at the cost of more comparisons per level
+     *  and Insert gets cheaper.
+     *
+     *  Array is aligned to cache line and root is placed at index Arity - 1, with the sentinel just before it.
+     *  Children of node i occupy [Arity * (i - Arity + 2), Arity * (i - Arity + 3)), so first child
+     *  index is always multiple of Arity and whole group of siblings starts at Arity-element boundary -
+     *  for Arity * sizeof(mPair) <= 64 all children of a node lie inside single cache line.
+     *  Indexes before the sentinel are only padding. For Arity = 2 layout is the classical one: root at 1, sentinel at 0.
+     *
+     *  Sift-down prefetches all grandchildren (they are contiguous) before choosing the child, so the next level
+     *  is loaded while the actual one is compared. Child is chosen with AVX2 for arithmetic priorities ordered
+     *  by std::greater/std::less, see heapChildSelection.h.
+     */
+
     // ------------------------------
     // Type creation/copying
     // ------------------------------
 public:
     using mPair = std::pair<PrioT, ItemT>;
 private:
-    using base = TArrayBasedStructure<mPair, IsMemSafe>;
+    using base = TArrayBasedStructure<mPair, IsMemSafe, HeapCacheLineSize>;
     using base::GetElemCount;
     using base::GetEndP;
     using base::AddLast;
     using base::RemoveLast;
     using base::RemoveAndReturn;
     using base::GetItem;
+    using base::ExpandArray;
+    using base::PasteArrayInto;
+    using layout = _dAryHeapLayout<Arity>;
+    using layout::_getParent;
+    using layout::_getFirstChild;
 public:
 
-    _baseHeapT(): TArrayBasedStructure<mPair, IsMemSafe>() {
+    _baseHeapT(): base() {
         // Ading Sentinel
-        AddLast(std::make_pair(MostSignificantPrio, ItemT{}));
+        _addSentinel();
     }
 
     _baseHeapT(const mPair* const items, const size_t size):
-        TArrayBasedStructure<mPair, IsMemSafe>(items, size, size+1, 1){
+        base(items, size, size + RootIndex, RootIndex){
 
         // Adding Sentinel
-        GetItem(0) = std::make_pair(MostSignificantPrio, ItemT{});
+        for (size_t i = 0; i < RootIndex; ++i)
+            GetItem(i) = std::make_pair(MostSignificantPrio, ItemT{});
         _createHeapDownToUp();
     }
 
-    _baseHeapT(const _baseHeapT& other): TArrayBasedStructure<mPair, IsMemSafe>(other) {}
-    _baseHeapT(_baseHeapT&& other) noexcept(true): TArrayBasedStructure<mPair, IsMemSafe>(std::move(other)){}
+    _baseHeapT(const _baseHeapT& other): base(other) {}
+    _baseHeapT(_baseHeapT&& other) noexcept(true): base(std::move(other)){}
 
     _baseHeapT& operator=(_baseHeapT&& other) noexcept(true) {
         base::operator=(std::move(other));
@@ -82,13 +109,13 @@ public:
     }
 
     [[nodiscard]] size_t ElementsCount() const {
-        return GetEndP()-1;
+        return GetEndP() - RootIndex;
     }
 
     [[nodiscard]] size_t GetLastIndex() const
         // offset ready for HeapIndexClass
     {
-        return GetEndP() - 2;
+        return ElementsCount() - 1;
     }
 
     _baseHeapT& Insert(const mPair& pair) {
@@ -96,16 +123,36 @@ public:
         return *this;
     }
 
+    _baseHeapT& InsertBatch(const mPair* const items, const size_t size)
+        // Appends all items at once. Small batches are sifted up one by one, larger ones are fixed with Floyd
+        // rebuild limited to ancestors of new items. Fixed cost of the rebuild is about height^2 sifts, so it is
+        // chosen once batch size reaches squared height - from there it keeps up with sifting up random items
+        // and is much faster for items more significant than the actual ones.
+    {
+        if (size == 0) return *this;
+
+        _reserve(GetEndP() + size);
+        PasteArrayInto(items, size);
+
+        if (const size_t height = _getHeight(ElementsCount()); size < height * height) {
+            for (size_t i = GetEndP() - size; i < GetEndP(); ++i)
+                _upHeap(i);
+        }
+        else _heapifyAppended(GetEndP() - size);
+
+        return *this;
+    }
+
     [[nodiscard]] const mPair& Max() const
         // when heap is empty behaviour is undefined
     {
-        return GetItem(1);
+        return GetItem(RootIndex);
     }
 
     _baseHeapT& DeleteMax(mPair& out)
         // when heap is empty behaviour is undefined
     {
-        out = GetItem(1);
+        out = GetItem(RootIndex);
 
         _deleteMax();
         return *this;
@@ -118,8 +165,22 @@ public:
         return *this;
     }
 
+    size_t DeleteMaxBatch(const size_t count, mPair* const out)
+        // Removes up to count most significant elements, out receives them in order of significance.
+        // Return: number of removed elements - smaller than count only when heap got empty
+    {
+        const size_t removed = std::min(count, ElementsCount());
+
+        for (size_t i = 0; i < removed; ++i) {
+            out[i] = GetItem(RootIndex);
+            _deleteMax();
+        }
+
+        return removed;
+    }
+
     [[nodiscard]] bool IsEmpty() const{
-        return GetEndP() == 1;
+        return GetEndP() == RootIndex;
     }
 
     [[nodiscard]] HeapIndex Search(PrioT prio)
@@ -127,14 +188,15 @@ public:
         // Return: index of found element. Output can be invalid
     {
         HeapIndex ret{};
-        ret.index = _search(prio, 1);
+        if (const size_t pos = _search(prio, RootIndex); pos != 0)
+            ret.index = pos - SentinelIndex;
         return ret;
     }
 
     _baseHeapT& Delete(const HeapIndex index, mPair& out)
         // when heap is empty or index is out of range behaviour is undefined
     {
-        const size_t i = index;
+        const size_t i = _getPosition(index);
         out = GetItem(i);
         _delete(i);
 
@@ -144,7 +206,7 @@ public:
     _baseHeapT& Delete(const HeapIndex index)
     // when heap is empty or index is out of range behaviour is undefined
     {
-        const size_t i = index;
+        const size_t i = _getPosition(index);
         _delete(i);
         return *this;
     }
@@ -152,7 +214,7 @@ public:
     _baseHeapT& Replace(const HeapIndex ind, const mPair& newItem, mPair& oItem)
         // when heap is empty or index is out of range behaviour is undefined
     {
-        const size_t i = ind;
+        const size_t i = _getPosition(ind);
         oItem = GetItem(i);
         _replace(i, newItem);
         return *this;
@@ -161,7 +223,7 @@ public:
     _baseHeapT& Replace(const HeapIndex ind, const mPair& newItem)
     // when heap is empty or index is out of range behaviour is undefined
     {
-        const size_t i = ind;
+        const size_t i = _getPosition(ind);
         _replace(i, newItem);
         return *this;
     }
@@ -169,7 +231,7 @@ public:
     const mPair& operator[](const HeapIndex ind) const
         // when heap is empty or index is out of range behaviour is undefined
     {
-        return GetItem(ind);
+        return GetItem(_getPosition(ind));
     }
 
     // ------------------------------
@@ -180,11 +242,11 @@ private:
         if (IsEmpty()) return 0;
         std::ostringstream str{};
 
-        str << std::get<0>(GetItem(1));
+        str << std::get<0>(GetItem(RootIndex));
         size_t max = str.str().length();
         str = std::ostringstream{};
 
-        for (size_t i = 2; i < GetEndP(); ++i) {
+        for (size_t i = RootIndex + 1; i < GetEndP(); ++i) {
             str << std::get<0>(GetItem(i));
             if (str.str().length() > max) {
                 max = str.str().length();
@@ -213,8 +275,8 @@ private:
     }
 
     void _deleteMax() {
-        GetItem(1) = RemoveAndReturn();
-        _downHeap(1);
+        GetItem(RootIndex) = RemoveAndReturn();
+        _downHeap(RootIndex);
     }
 
     std::ostream& _print(std::ostream& out, const _baseHeapT& hp) const {
@@ -224,21 +286,30 @@ private:
             }
         };
 
-        if (hp.GetEndP() == 1) {
+        if (hp.IsEmpty()) {
             out << "[ Empty heap ]";
             return out;
         }
 
         const size_t elemStringSize = hp._findMaxPrint(); // slow but needed
         out << std::setw(elemStringSize) << std::setfill(' ');
-        const size_t height = std::log2(hp.GetEndP() - 1) + 1; // EndP = n + 1;
-        const size_t MaxLastRowElements = 1 << height - 1;
-        const size_t beforeLastRowElements = MaxLastRowElements - 1;
-        const size_t LastRowElements = hp.GetEndP() - beforeLastRowElements - 1;
+
+        // levels are filled one by one, so height is the number of full levels needed to hold all elements
+        size_t height = 1;
+        size_t MaxLastRowElements = 1;
+        size_t beforeLastRowElements = 0;
+        while (beforeLastRowElements + MaxLastRowElements < hp.ElementsCount()) {
+            beforeLastRowElements += MaxLastRowElements;
+            MaxLastRowElements *= Arity;
+            ++height;
+        }
+
+        const size_t LastRowElements = hp.ElementsCount() - beforeLastRowElements;
         const size_t LastRowSpacing = PrintSpaceDist + elemStringSize;
         const size_t LastLayerChars = MaxLastRowElements * elemStringSize + (MaxLastRowElements - 1) * LastRowSpacing;
 
         size_t elemPerLayer = 1;
+        size_t layerStart = RootIndex;
         for(size_t i = 1; i <= height-1; ++i) {
             const size_t firstElemDist = std::floor((double)(LastLayerChars - elemPerLayer*elemStringSize) / (double)(elemPerLayer * 2));
             const size_t interElemDist = elemPerLayer == 1 ? 0 :
@@ -246,17 +317,18 @@ private:
 
             printOffset(firstElemDist);
             for(size_t j = 0; j < elemPerLayer; ++j) {
-                out << std::get<0>(hp.GetItem(elemPerLayer + j));
+                out << std::get<0>(hp.GetItem(layerStart + j));
                 printOffset(interElemDist);
             }
 
             out << SpacingString;
-            elemPerLayer *= 2;
+            layerStart += elemPerLayer;
+            elemPerLayer *= Arity;
         }
 
         // cleaning last line
         for(size_t j = 0; j < LastRowElements; ++j) {
-            out << std::get<0>(hp.GetItem(elemPerLayer + j));
+            out << std::get<0>(hp.GetItem(layerStart + j));
             printOffset(LastRowSpacing);
         }
         out << std::endl;
@@ -269,8 +341,8 @@ private:
             return;
         }
 
-        GetItem(i) = RemoveAndReturn();
-        _downHeap(i);
+        // last element may be more significant than parent of the removed one
+        _replace(i, RemoveAndReturn());
     }
 
     void _replace(size_t i, const mPair& item) {
@@ -287,12 +359,10 @@ private:
             return 0;
         }
 
-        if (const size_t lChild = _getLeftChild(ind) ;  lChild < GetEndP()) {
-            if (const size_t lChildResult = _search(prio, lChild) ; lChildResult != 0) return lChildResult;
-
-            if (const size_t rChild = lChild + 1 ; lChild + 1 < GetEndP()) {
-                if (const size_t rChildResult = _search(prio, rChild); rChildResult != 0) return rChildResult;
-            }
+        const size_t firstChild = _getFirstChild(ind);
+        const size_t lastChild = std::min(firstChild + Arity, GetEndP());
+        for (size_t child = firstChild; child < lastChild; ++child) {
+            if (const size_t childResult = _search(prio, child) ; childResult != 0) return childResult;
         }
 
         return 0;
@@ -313,11 +383,11 @@ private:
         mPair elem = GetItem(i);
 
         const size_t maxInd = GetEndP();
-        for (size_t childInd = _getLeftChild(i); childInd < maxInd; childInd = _getLeftChild(i)) {
-            if (const size_t rChild = childInd + 1; rChild < maxInd) {
-                if (pred(GetItem(rChild).first, GetItem(childInd).first))
-                    childInd = rChild;
-            }
+        for (size_t firstChild = _getFirstChild(i); firstChild < maxInd; firstChild = _getFirstChild(i)) {
+            const size_t lastChild = std::min(firstChild + Arity, maxInd);
+            heapPrefetchGrandchildren<Arity>(&GetItem(0), firstChild, lastChild, maxInd);
+
+            const size_t childInd = heapSelectChild<Arity>(&GetItem(0), firstChild, lastChild, pred);
 
             if (pred(GetItem(childInd).first, elem.first)) {
                 GetItem(i) = GetItem(childInd);
@@ -330,9 +400,15 @@ private:
     }
 
     // Private constructor used only inside UpToDown factory.
-    explicit _baseHeapT(const size_t initSize): TArrayBasedStructure<mPair, IsMemSafe>(initSize+1) {
+    explicit _baseHeapT(const size_t initSize): base(initSize + RootIndex) {
         // Ading Sentinel
-        AddLast(std::make_pair(MostSignificantPrio, ItemT()));
+        _addSentinel();
+    }
+
+    // fills padding and sentinel slots, padding holds sentinel values as well
+    void _addSentinel() {
+        for (size_t i = 0; i < RootIndex; ++i)
+            AddLast(std::make_pair(MostSignificantPrio, ItemT{}));
     }
 
     void _createHeapUpToDown(const mPair* const items, const size_t size) {
@@ -341,32 +417,59 @@ private:
         }
     }
 
-    // Expects all elements to be actually copied inside underlying array.
-    void _createHeapDownToUp() {
-        const size_t height = std::log2(GetEndP() - 1) + 1; // EndP = n + 1;
-        const size_t MaxLastRowElements = 1 << height - 1;
-        const size_t beforeLastRowElements = MaxLastRowElements - 1;
+    // Restores heap after elements [first, GetEndP()) were appended. Only ancestors of new elements are sifted:
+    // ancestors of contiguous range form contiguous range on every level, so ranges are processed from the bottom
+    // just like in _createHeapDownToUp. Cost is O(k + log^2 n) for k appended elements.
+    void _heapifyAppended(const size_t first) {
+        if (ElementsCount() < 2) return;
+
+        size_t lo = std::max(_getParent(first), RootIndex);
+        size_t hi = _getParent(GetEndP() - 1);
+        while (true) {
+            for (size_t i = hi + 1; i > lo; --i)
+                _downHeap(i - 1);
 
-        for(int i = beforeLastRowElements; i >= 1; --i)
-            _downHeap(i);
+            if (lo == RootIndex) break;
+            lo = _getParent(lo);
+            hi = _getParent(hi);
+        }
     }
 
-    static constexpr size_t _getParent(const size_t index) {
-        return index / 2;
+    // number of levels of the heap with count elements
+    static constexpr size_t _getHeight(const size_t count) {
+        return (std::bit_width(count) + ArityLog - 1) / ArityLog;
     }
 
-    static constexpr size_t _getLeftChild(const size_t index) {
-        return 2 * index;
+    // array is grown at least twice, so series of batches stays amortized O(1) per element
+    void _reserve(const size_t endP) {
+        if (endP > GetElemCount())
+            ExpandArray(std::max(endP, 2 * GetElemCount()));
     }
 
-    static constexpr size_t _getRightChild(const size_t index) {
-        return _getLeftChild(index) + 1;
+    // Expects all elements to be actually copied inside underlying array.
+    void _createHeapDownToUp() {
+        if (ElementsCount() < 2) return;
+
+        // starting from parent of the last element, so only inner nodes are sifted
+        for(size_t i = _getParent(GetEndP() - 1) + 1; i > RootIndex; --i)
+            _downHeap(i - 1);
+    }
+
+    // HeapIndex holds position counted from 1, so 0 stays invalid for every arity
+    static constexpr size_t _getPosition(const HeapIndex ind) {
+        return ind() + SentinelIndex;
     }
 
     // ------------------------------
     // private class Fields
     // ------------------------------
 
+public:
+    using layout::RootIndex;
+    using layout::SentinelIndex;
+private:
+    using layout::ArityLog;
+
     PriorityFunction pred{};
     inline static unsigned int PrintSpaceDist = 3;
     inline static std::string SpacingString = std::string(PrintSpaceDist, '\n');
@@ -0,0 +1,256 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "_baseHeapT.h"
+
+template<typename PrioT, typename ItemT, typename PriorityFunction, PrioT MostSignificantPrio, size_t Arity = 2>
+class _indexedHeapT: public TArrayBasedStructure<std::pair<PrioT, uint32_t>, IsMemSafe, HeapCacheLineSize>, _dAryHeapLayout<Arity> {
+    /*                  Description
+     *  Addressable variant of _baseHeapT. Insert returns HeapHandle, which identifies the element until it is
+     *  removed, no matter how the heap changes. Heap array holds only priorities together with 32-bit handles,
+     *  items are kept aside in array indexed by handles, so sifts move small nodes only.
+     *
+     *  Every sift updates handle -> position array for each moved node, so element of given handle is found
+     *  in O(1) and DecreaseKey, IncreaseKey and Erase work in O(log n) without any searching - as needed
+     *  by Dijkstra or by cancelling timers. Handles of removed elements are reused by next insertions.
+     *
+     *  Layout of the array (sentinel, arity, cache line alignment) and child selection are shared with _baseHeapT,
+     *  see heapChildSelection.h.
+     */
+
+    using node = std::pair<PrioT, uint32_t>;
+
+    // ------------------------------
+    // Type creation/copying
+    // ------------------------------
+public:
+    using mPair = std::pair<PrioT, ItemT>;
+private:
+    using base = TArrayBasedStructure<node, IsMemSafe, HeapCacheLineSize>;
+    using base::GetEndP;
+    using base::AddLast;
+    using base::RemoveAndReturn;
+    using base::GetItem;
+    using layout = _dAryHeapLayout<Arity>;
+    using layout::_getParent;
+    using layout::_getFirstChild;
+public:
+
+    _indexedHeapT(): base() {
+        // Adding Sentinel, padding slots hold sentinel values as well
+        for (size_t i = 0; i < RootIndex; ++i)
+            AddLast(node{ MostSignificantPrio, HeapHandle::InvalidHandle });
+    }
+
+    _indexedHeapT(const _indexedHeapT& other) = default;
+    _indexedHeapT(_indexedHeapT&& other) noexcept(true) = default;
+    _indexedHeapT& operator=(const _indexedHeapT& other) = default;
+    _indexedHeapT& operator=(_indexedHeapT&& other) noexcept(true) = default;
+
+    ~_indexedHeapT() = default;
+
+    // ------------------------------
+    // class interaction
+    // ------------------------------
+
+    [[nodiscard]] size_t ElementsCount() const {
+        return GetEndP() - RootIndex;
+    }
+
+    [[nodiscard]] bool IsEmpty() const {
+        return GetEndP() == RootIndex;
+    }
+
+    HeapHandle Insert(const mPair& pair)
+        // Return: handle of inserted element
+        // Note: throws std::runtime_error, when heap exceeds 2^32 - 1 elements
+    {
+        const uint32_t handle = _acquireHandle(pair.second);
+        const size_t pos = GetEndP();
+
+        AddLast(node{ pair.first, handle });
+        _positions[handle] = pos;
+        _upHeap(pos);
+
+        return HeapHandle(handle);
+    }
+
+    [[nodiscard]] mPair Max() const
+        // when heap is empty behaviour is undefined
+    {
+        const node& root = GetItem(RootIndex);
+        return std::make_pair(root.first, _items[root.second]);
+    }
+
+    [[nodiscard]] HeapHandle MaxHandle() const
+        // when heap is empty behaviour is undefined
+    {
+        return HeapHandle(GetItem(RootIndex).second);
+    }
+
+    _indexedHeapT& DeleteMax(mPair& out)
+        // when heap is empty behaviour is undefined
+    {
+        out = Max();
+        _erase(RootIndex);
+        return *this;
+    }
+
+    _indexedHeapT& DeleteMax()
+        // when heap is empty behaviour is undefined
+    {
+        _erase(RootIndex);
+        return *this;
+    }
+
+    [[nodiscard]] bool Contains(const HeapHandle handle) const {
+        return handle.isValid() && handle < _positions.size() && _positions[handle] != NotInHeap;
+    }
+
+    // Note: for all methods below handle has to be contained, otherwise behaviour is undefined
+
+    [[nodiscard]] PrioT GetPriority(const HeapHandle handle) const {
+        return GetItem(_positions[handle]).first;
+    }
+
+    [[nodiscard]] const ItemT& GetValue(const HeapHandle handle) const {
+        return _items[handle];
+    }
+
+    [[nodiscard]] ItemT& GetValue(const HeapHandle handle) {
+        return _items[handle];
+    }
+
+    _indexedHeapT& DecreaseKey(const HeapHandle handle, const PrioT prio)
+        // For std::less ordered heap (e.g. Dijkstra) element moves towards the root, for std::greater towards leaves.
+    {
+        _changeKey(_positions[handle], prio);
+        return *this;
+    }
+
+    _indexedHeapT& IncreaseKey(const HeapHandle handle, const PrioT prio) {
+        _changeKey(_positions[handle], prio);
+        return *this;
+    }
+
+    _indexedHeapT& Erase(const HeapHandle handle, mPair& out) {
+        out = std::make_pair(GetPriority(handle), _items[handle]);
+        _erase(_positions[handle]);
+        return *this;
+    }
+
+    _indexedHeapT& Erase(const HeapHandle handle) {
+        _erase(_positions[handle]);
+        return *this;
+    }
+
+    // -------------------------------
+    // implementation-components
+    // -------------------------------
+private:
+
+    uint32_t _acquireHandle(const ItemT& item) {
+        if (!_freeHandles.empty()) {
+            const uint32_t handle = _freeHandles.back();
+            _freeHandles.pop_back();
+
+            _items[handle] = item;
+            return handle;
+        }
+
+        if (_items.size() >= HeapHandle::InvalidHandle)
+            throw std::runtime_error("[ ERROR ] Indexed heap exceeded maximal number of handles.");
+
+        _items.push_back(item);
+        _positions.push_back(NotInHeap);
+        return static_cast<uint32_t>(_items.size() - 1);
+    }
+
+    void _releaseHandle(const uint32_t handle) {
+        _positions[handle] = NotInHeap;
+        _items[handle] = ItemT{};
+        _freeHandles.push_back(handle);
+    }
+
+    void _place(const size_t pos, const node& elem) {
+        GetItem(pos) = elem;
+        _positions[elem.second] = pos;
+    }
+
+    void _erase(const size_t pos) {
+        _releaseHandle(GetItem(pos).second);
+
+        const node last = RemoveAndReturn();
+        if (pos == GetEndP()) return;
+
+        _place(pos, last);
+        _sift(pos);
+    }
+
+    void _changeKey(const size_t pos, const PrioT prio) {
+        GetItem(pos).first = prio;
+        _sift(pos);
+    }
+
+    // direction is chosen by comparison with the parent, parent of the root is the sentinel
+    void _sift(const size_t pos) {
+        if (pred(GetItem(pos).first, GetItem(_getParent(pos)).first)) _upHeap(pos);
+        else _downHeap(pos);
+    }
+
+    void _upHeap(size_t i) {
+        const node elem = GetItem(i);
+
+        for(size_t pInd = _getParent(i); pred(elem.first, GetItem(pInd).first); pInd = _getParent(i) ) {
+            _place(i, GetItem(pInd));
+            i = pInd;
+        }
+
+        _place(i, elem);
+    }
+
+    void _downHeap(size_t i) {
+        const node elem = GetItem(i);
+
+        const size_t maxInd = GetEndP();
+        for (size_t firstChild = _getFirstChild(i); firstChild < maxInd; firstChild = _getFirstChild(i)) {
+            const size_t lastChild = std::min(firstChild + Arity, maxInd);
+            heapPrefetchGrandchildren<Arity>(&GetItem(0), firstChild, lastChild, maxInd);
+
+            const size_t childInd = heapSelectChild<Arity>(&GetItem(0), firstChild, lastChild, pred);
+            if (pred(GetItem(childInd).first, elem.first)) {
+                _place(i, GetItem(childInd));
+                i = childInd;
+            }
+            else break;
+        }
+
+        _place(i, elem);
+    }
+
+    // ------------------------------
+    // private class Fields
+    // ------------------------------
+
+public:
+    using layout::RootIndex;
+    using layout::SentinelIndex;
+    static constexpr size_t NotInHeap = SIZE_MAX;
+private:
+    std::vector<ItemT> _items{}; // indexed by handles
+    std::vector<size_t> _positions{}; // indexed by handles, NotInHeap for free ones
+    std::vector<uint32_t> _freeHandles{};
+
+    PriorityFunction pred{};
+};
+
+#endif //INDEXEDHEAP_H
@@ -0,0 +1,319 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef HEAPCHILDSELECTION_H
+#define HEAPCHILDSELECTION_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*                  Description
+ *  Helpers shared by array heaps (_baseHeapT, _indexedHeapT): index math of the d-ary layout and sift-down child
+ *  selection with prefetching. Selection of most significant child is horizontal max (or min) over
+ *  all siblings, which for arithmetic priorities compared with std::greater/std::less is done with AVX2:
+ *  priorities are gathered from the pairs (Stride is size of the pair in PrioT units, pairs with Stride 2 are
+ *  read with plain loads and shuffled), reduced inside the registers and position of the winner is taken
+ *  from equality mask. Other priority types, comparers or builds without AVX2 use plain scalar loop.
+ *
+ *  Note: siblings have to fill at least two registers - 16 siblings for 32-bit priorities, 8 for 64-bit ones.
+ */
+
+static constexpr size_t HeapCacheLineSize = 64;
+
+// grandchildren spanning more bytes are not prefetched - too many requests for single level
+static constexpr size_t HeapMaxPrefetchBytes = 8 * HeapCacheLineSize;
+
+// Index math of d-ary heap array, root is placed at Arity - 1 with the sentinel just before it, so first child
+// of every node lies at Arity-element boundary (see _baseHeapT). Heaps inherit it to share the constants.
+template<size_t Arity>
+struct _dAryHeapLayout {
+    static_assert(Arity == 2 || Arity == 4 || Arity == 8 || Arity == 16, "Heap arity has to be 2, 4, 8 or 16");
+
+    static constexpr size_t RootIndex = Arity - 1;
+    static constexpr size_t SentinelIndex = Arity - 2;
+    static constexpr size_t ArityLog = std::countr_zero(Arity);
+
+    // parent of the root is the sentinel
+    static constexpr size_t _getParent(const size_t index) {
+        return index / Arity + SentinelIndex;
+    }
+
+    static constexpr size_t _getFirstChild(const size_t index) {
+        return Arity * (index - SentinelIndex);
+    }
+};
+
+// 1 - most significant priority is the greatest one, -1 - the smallest one, 0 - comparer unknown
+template<typename PriorityFunction, typename PrioT>
+inline constexpr int HeapOrderDirection = 0;
+
+template<typename PrioT>
+inline constexpr int HeapOrderDirection<std::greater<>, PrioT> = 1;
+
+template<typename PrioT>
+inline constexpr int HeapOrderDirection<std::greater<PrioT>, PrioT> = 1;
+
+template<typename PrioT>
+inline constexpr int HeapOrderDirection<std::less<>, PrioT> = -1;
+
+template<typename PrioT>
+inline constexpr int HeapOrderDirection<std::less<PrioT>, PrioT> = -1;
+
+// Hints the cpu to load all cache lines of [begin, end)
+inline void heapPrefetchRange(const void* const begin, const void* const end) {
+    const auto last = reinterpret_cast<uintptr_t>(end);
+
+    for (uintptr_t ptr = reinterpret_cast<uintptr_t>(begin) & ~(HeapCacheLineSize - 1); ptr < last; ptr += HeapCacheLineSize)
+        __builtin_prefetch(reinterpret_cast<const void*>(ptr));
+}
+
+// Lanes describe single AVX2 register of priorities, Count = 0 means no vectorized selection for the type
+template<typename PrioT>
+struct _heapSimdLanes {
+    static constexpr size_t Count = 0;
+};
+
+#if defined(__AVX2__)
+
+template<>
+struct _heapSimdLanes<double> {
+    using VecT = __m256d;
+    static constexpr size_t Count = 4;
+
+    // pairs of 16 bytes are read with two plain loads, priorities are then in order 0, 2, 1, 3
+    template<size_t Stride>
+    static VecT gather(const double* base) {
+        if constexpr (Stride == 2) {
+            const __m256d lo = _mm256_loadu_pd(base);
+            const __m256d hi = _mm256_loadu_pd(base + 4);
+            return _mm256_unpacklo_pd(lo, hi);
+        }
+        else {
+            return _mm256_i32gather_pd(base, _mm_setr_epi32(0, Stride, 2 * Stride, 3 * Stride), sizeof(double));
+        }
+    }
+
+    template<size_t Stride>
+    static size_t lanePosition(const size_t lane) {
+        if constexpr (Stride == 2) return (lane & 1) << 1 | lane >> 1;
+        else return lane;
+    }
+
+    template<bool SelectMax>
+    static VecT best(const VecT a, const VecT b) {
+        return SelectMax ? _mm256_max_pd(a, b) : _mm256_min_pd(a, b);
+    }
+
+    // result holds the best value in every lane
+    template<bool SelectMax>
+    static VecT reduce(VecT v) {
+        v = best<SelectMax>(v, _mm256_permute2f128_pd(v, v, 0x01));
+        return best<SelectMax>(v, _mm256_shuffle_pd(v, v, 0b0101));
+    }
+
+    static uint32_t equalMask(const VecT a, const VecT b) {
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+    }
+};
+
+// pairs of 8 bytes are read with two plain loads, priorities are then in order 0, 1, 4, 5, 2, 3, 6, 7
+template<size_t Stride>
+__m256 _heapGather32(const void* const base) {
+    const auto* const prios = static_cast<const float*>(base);
+
+    if constexpr (Stride == 2) {
+        const __m256 lo = _mm256_loadu_ps(prios);
+        const __m256 hi = _mm256_loadu_ps(prios + 8);
+        return _mm256_shuffle_ps(lo, hi, 0x88);
+    }
+    else {
+        const __m256i idx = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(Stride));
+        return _mm256_i32gather_ps(prios, idx, sizeof(float));
+    }
+}
+
+template<size_t Stride>
+size_t _heapLanePosition32(const size_t lane) {
+    if constexpr (Stride == 2) return (lane & 0b001) | (lane & 0b010) << 1 | (lane & 0b100) >> 1;
+    else return lane;
+}
+
+template<>
+struct _heapSimdLanes<float> {
+    using VecT = __m256;
+    static constexpr size_t Count = 8;
+
+    template<size_t Stride>
+    static VecT gather(const float* base) {
+        return _heapGather32<Stride>(base);
+    }
+
+    template<size_t Stride>
+    static size_t lanePosition(const size_t lane) {
+        return _heapLanePosition32<Stride>(lane);
+    }
+
+    template<bool SelectMax>
+    static VecT best(const VecT a, const VecT b) {
+        return SelectMax ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b);
+    }
+
+    template<bool SelectMax>
+    static VecT reduce(VecT v) {
+        v = best<SelectMax>(v, _mm256_permute2f128_ps(v, v, 0x01));
+        v = best<SelectMax>(v, _mm256_shuffle_ps(v, v, 0x4E));
+        return best<SelectMax>(v, _mm256_shuffle_ps(v, v, 0xB1));
+    }
+
+    static uint32_t equalMask(const VecT a, const VecT b) {
+        return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+    }
+};
+
+template<typename PrioT> requires (std::is_integral_v<PrioT> && sizeof(PrioT) == sizeof(int32_t))
+struct _heapSimdLanes<PrioT> {
+    using VecT = __m256i;
+    static constexpr size_t Count = 8;
+
+    template<size_t Stride>
+    static VecT gather(const PrioT* base) {
+        return _mm256_castps_si256(_heapGather32<Stride>(base));
+    }
+
+    template<size_t Stride>
+    static size_t lanePosition(const size_t lane) {
+        return _heapLanePosition32<Stride>(lane);
+    }
+
+    template<bool SelectMax>
+    static VecT best(const VecT a, const VecT b) {
+        if constexpr (std::is_signed_v<PrioT>)
+            return SelectMax ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+        else
+            return SelectMax ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+    }
+
+    template<bool SelectMax>
+    static VecT reduce(VecT v) {
+        v = best<SelectMax>(v, _mm256_permute2x128_si256(v, v, 0x01));
+        v = best<SelectMax>(v, _mm256_shuffle_epi32(v, 0x4E));
+        return best<SelectMax>(v, _mm256_shuffle_epi32(v, 0xB1));
+    }
+
+    static uint32_t equalMask(const VecT a, const VecT b) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+    }
+};
+
+// AVX2 has only signed 64-bit comparison, so unsigned 64-bit priorities stay scalar
+template<typename PrioT> requires (std::is_integral_v<PrioT> && std::is_signed_v<PrioT> && sizeof(PrioT) == sizeof(int64_t))
+struct _heapSimdLanes<PrioT> {
+    using VecT = __m256i;
+    static constexpr size_t Count = 4;
+
+    template<size_t Stride>
+    static VecT gather(const PrioT* base) {
+        return _mm256_i32gather_epi64(reinterpret_cast<const long long*>(base),
+            _mm_setr_epi32(0, Stride, 2 * Stride, 3 * Stride), sizeof(PrioT));
+    }
+
+    template<bool SelectMax>
+    static VecT best(const VecT a, const VecT b) {
+        const __m256i aGreater = _mm256_cmpgt_epi64(a, b);
+        return SelectMax ? _mm256_blendv_epi8(b, a, aGreater) : _mm256_blendv_epi8(a, b, aGreater);
+    }
+
+    template<bool SelectMax>
+    static VecT reduce(VecT v) {
+        v = best<SelectMax>(v, _mm256_permute2x128_si256(v, v, 0x01));
+        return best<SelectMax>(v, _mm256_shuffle_epi32(v, 0x4E));
+    }
+
+    static uint32_t equalMask(const VecT a, const VecT b) {
+        return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+    }
+};
+
+#endif
+
+// single register does not pay off - reduction latency is longer than few well predicted scalar comparisons
+template<typename PrioT, typename PriorityFunction, size_t Count>
+inline constexpr bool HeapSimdSelectable = HeapOrderDirection<PriorityFunction, PrioT> != 0
+    && _heapSimdLanes<PrioT>::Count != 0 && Count % _heapSimdLanes<PrioT>::Count == 0
+    && Count >= 2 * _heapSimdLanes<PrioT>::Count;
+
+// Returns position of the most significant among Count priorities placed every Stride elements of PrioT,
+// on ties the first one is chosen. Note: usable only when HeapSimdSelectable holds
+template<typename PrioT, typename PriorityFunction, size_t Count, size_t Stride>
+size_t heapSimdSelect(const PrioT* const prios) {
+    using lanes = _heapSimdLanes<PrioT>;
+    static constexpr bool SelectMax = HeapOrderDirection<PriorityFunction, PrioT> > 0;
+    static constexpr size_t VecCount = Count / lanes::Count;
+
+    typename lanes::VecT vecs[VecCount];
+    for (size_t v = 0; v < VecCount; ++v)
+        vecs[v] = lanes::template gather<Stride>(prios + v * lanes::Count * Stride);
+
+    typename lanes::VecT best = vecs[0];
+    for (size_t v = 1; v < VecCount; ++v)
+        best = lanes::template best<SelectMax>(best, vecs[v]);
+    best = lanes::template reduce<SelectMax>(best);
+
+    uint32_t mask = 0;
+    for (size_t v = 0; v < VecCount; ++v)
+        mask |= lanes::equalMask(vecs[v], best) << (v * lanes::Count);
+
+    // NaN priorities never compare equal, then any child is as good as other ones
+    if (mask == 0) return 0;
+
+    const size_t winner = std::countr_zero(mask);
+    if constexpr (requires { lanes::template lanePosition<Stride>(winner); })
+        return winner - winner % lanes::Count + lanes::template lanePosition<Stride>(winner % lanes::Count);
+    else
+        return winner;
+}
+
+// Returns most significant of the siblings [firstChild, lastChild) of nodes array, nodes hold priority as 'first'.
+// Siblings lie inside the same aligned group, so full groups are selected with SIMD, when available
+template<size_t Arity, typename NodeT, typename PriorityFunction>
+size_t heapSelectChild(const NodeT* const nodes, const size_t firstChild, const size_t lastChild, const PriorityFunction& pred) {
+    using PrioT = typename NodeT::first_type;
+
+    if constexpr (HeapSimdSelectable<PrioT, PriorityFunction, Arity> && sizeof(NodeT) % sizeof(PrioT) == 0) {
+        if (lastChild - firstChild == Arity) [[likely]]
+            return firstChild + heapSimdSelect<PrioT, PriorityFunction, Arity, sizeof(NodeT) / sizeof(PrioT)>(&nodes[firstChild].first);
+    }
+
+    size_t childInd = firstChild;
+    for (size_t child = firstChild + 1; child < lastChild; ++child) {
+        if (pred(nodes[child].first, nodes[childInd].first))
+            childInd = child;
+    }
+
+    return childInd;
+}
+
+// children of consecutive siblings are consecutive, so whole next level of the sift is one range
+template<size_t Arity, typename NodeT>
+void heapPrefetchGrandchildren(const NodeT* const nodes, const size_t firstChild, const size_t lastChild, const size_t endP) {
+    using layout = _dAryHeapLayout<Arity>;
+
+    if constexpr (Arity * Arity * sizeof(NodeT) <= HeapMaxPrefetchBytes) {
+        const size_t first = layout::_getFirstChild(firstChild);
+        if (first >= endP) return;
+
+        const size_t last = std::min(layout::_getFirstChild(lastChild - 1) + Arity, endP);
+        heapPrefetchRange(nodes + first, nodes + last);
+    }
+}
+
+#endif //HEAPCHILDSELECTION_H
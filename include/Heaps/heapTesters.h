@@ -5,11 +5,16 @@
 #ifndef HEAPTESTERS_H
 #define HEAPTESTERS_H
 
+#include <algorithm>
 #include <cstdlib>
 #include <functional>
 #include <climits>
+#include <cstdint>
 #include <cfloat>
 #include <string>
+#include <chrono>
+#include <random>
+#include <vector>
 
 #include "../Debuggers.hpp"
 
@@ -148,6 +153,234 @@ void HeapTest() {
     }
 }
 
+template<template<typename PrioT, typename , typename , PrioT MostSignificantPrio, size_t Arity> class HeapT, size_t Arity>
+void HeapArityMeasure(const std::vector<double>& prios) {
+    using doubleHeap = HeapT<double, double, std::greater<>, DBL_MAX, Arity>;
+    const size_t range = prios.size();
+
+    doubleHeap heap{};
+
+    // Timer prints every measurement, so plain clock keeps the table readable
+    auto start = std::chrono::steady_clock::now();
+    for (const double prio: prios) {
+        heap.Insert(std::make_pair(prio, prio));
+    }
+    const double insertTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    // counting order violations keeps the loop alive and checks the heap at once
+    size_t violations = 0;
+    double last = DBL_MAX;
+
+    start = std::chrono::steady_clock::now();
+    while (!heap.IsEmpty()) {
+        const double prio = heap.Max().first;
+        violations += prio > last;
+        last = prio;
+
+        heap.DeleteMax();
+    }
+    const double deleteTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Arity: " << Arity
+              << " | Insert: " << insertTime / range << " ns/op, " << range * 1e+3 / insertTime << " Mops/s"
+              << " | DeleteMax: " << deleteTime / range << " ns/op, " << range * 1e+3 / deleteTime << " Mops/s"
+              << " | order violations: " << violations << '\n';
+}
+
+template<template<typename PrioT, typename , typename , PrioT MostSignificantPrio, size_t Arity> class HeapT>
+void HeapArityTest() {
+    std::cout << "-----------------------------------------------------------------------------\n"
+              << "                 D-ary heap throughput for different arities\n"
+              << "-----------------------------------------------------------------------------\n";
+
+    // Note: 1e+8 pairs of doubles need about 2GB for the heap array only
+    static constexpr size_t testRanges[] = { static_cast<size_t>(1e+6), static_cast<size_t>(1e+7), static_cast<size_t>(1e+8) };
+
+    std::mt19937_64 gen{ 0 };
+    std::uniform_real_distribution<double> dist(0.0, 1e+9);
+
+    for (auto range: testRanges) {
+        std::cout << "-----------------------------";
+        std::cout << "\nMeasuring Insert and DeleteMax with: " << range << " random double precision floating point priorities\n";
+        std::cout << "-----------------------------\n";
+
+        std::vector<double> prios(range);
+        for (auto& prio: prios) {
+            prio = dist(gen);
+        }
+
+        HeapArityMeasure<HeapT, 2>(prios);
+        HeapArityMeasure<HeapT, 4>(prios);
+        HeapArityMeasure<HeapT, 8>(prios);
+        HeapArityMeasure<HeapT, 16>(prios);
+    }
+}
+
+template<template<typename PrioT, typename , typename , PrioT MostSignificantPrio, size_t Arity> class HeapT>
+void HeapBatchTest() {
+    using doubleHeap = HeapT<double, double, std::greater<>, DBL_MAX, 4>;
+    using mPair = std::pair<double, double>;
+
+    std::cout << "-----------------------------------------------------------------------------\n"
+              << "              Batched insertion and removal on 4-ary heap\n"
+              << "-----------------------------------------------------------------------------\n";
+
+    static constexpr size_t heapSize = static_cast<size_t>(1e+6);
+    static constexpr size_t batchSizes[] = { 10, 1000, 100000, 1000000 };
+
+    std::mt19937_64 gen{ 0 };
+    std::uniform_real_distribution<double> dist(0.0, 1e+9);
+
+    std::vector<mPair> base(heapSize);
+    for (auto& pair: base) {
+        pair.first = dist(gen);
+    }
+
+    auto elapsed = [](const auto start) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    for (const bool ascending: { false, true }) {
+        for (const size_t batchSize: batchSizes) {
+            std::vector<mPair> batch(batchSize);
+            for (size_t i = 0; i < batchSize; ++i) {
+                batch[i].first = ascending ? 1e+9 + static_cast<double>(i) : dist(gen);
+            }
+
+            // both heaps are grown before measuring, so array expansion is not counted
+            doubleHeap h1(base.data(), heapSize);
+            doubleHeap h2(base.data(), heapSize);
+            h1.InsertBatch(batch.data(), 1).DeleteMax();
+            h2.InsertBatch(batch.data(), 1).DeleteMax();
+
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& pair: batch) {
+                h1.Insert(pair);
+            }
+            const double singleTime = elapsed(start);
+
+            start = std::chrono::steady_clock::now();
+            h2.InsertBatch(batch.data(), batchSize);
+            const double batchTime = elapsed(start);
+
+            std::cout << (ascending ? "Ascending" : "Random") << " batch of " << batchSize << " items into heap of "
+                      << heapSize << " | Insert: " << singleTime / batchSize << " ns/item | InsertBatch: "
+                      << batchTime / batchSize << " ns/item\n";
+        }
+    }
+
+    doubleHeap heap(base.data(), heapSize);
+    std::vector<mPair> out(heapSize);
+    static constexpr size_t drainSize = 1000;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t drained = 0;
+    while (const size_t removed = heap.DeleteMaxBatch(drainSize, out.data() + drained)) {
+        drained += removed;
+    }
+    const double drainTime = elapsed(start);
+
+    const bool sorted = std::is_sorted(out.begin(), out.end(), [](const mPair& a, const mPair& b) { return a.first > b.first; });
+    std::cout << "Drained " << drained << " items with DeleteMaxBatch(" << drainSize << "): "
+              << drainTime / drained << " ns/item, order " << (sorted ? "correct" : "BROKEN") << '\n';
+}
+
+template<
+    template<typename PrioT, typename , typename , PrioT MostSignificantPrio, size_t Arity> class IndexedHeapT,
+    template<typename PrioT, typename , typename , PrioT MostSignificantPrio, size_t Arity> class HeapT
+>void IndexedHeapTest() {
+    using indexedHeap = IndexedHeapT<int64_t, uint32_t, std::less<>, INT64_MIN, 4>;
+    using lazyHeap = HeapT<int64_t, uint32_t, std::less<>, INT64_MIN, 4>;
+
+    std::cout << "-----------------------------------------------------------------------------\n"
+              << "         Dijkstra: DecreaseKey on indexed heap vs lazy deletion\n"
+              << "-----------------------------------------------------------------------------\n";
+
+    static constexpr size_t vertexCounts[] = { static_cast<size_t>(1e+5), static_cast<size_t>(1e+6) };
+    static constexpr size_t degree = 8;
+    static constexpr int64_t unreachable = INT64_MAX;
+
+    std::mt19937_64 gen{ 0 };
+
+    for (const size_t vertexCount: vertexCounts) {
+        // adjacency in flat arrays: edges of vertex v are [v * degree, (v + 1) * degree)
+        std::vector<uint32_t> targets(vertexCount * degree);
+        std::vector<int64_t> weights(vertexCount * degree);
+        for (size_t e = 0; e < targets.size(); ++e) {
+            targets[e] = static_cast<uint32_t>(gen() % vertexCount);
+            weights[e] = static_cast<int64_t>(gen() % 1000 + 1);
+        }
+
+        auto elapsed = [](const auto start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        std::vector<int64_t> lazyDist(vertexCount, unreachable);
+        size_t lazyPushes = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            lazyHeap heap{};
+            lazyDist[0] = 0;
+            heap.Insert(std::make_pair(int64_t{0}, uint32_t{0}));
+
+            while (!heap.IsEmpty()) {
+                std::pair<int64_t, uint32_t> top;
+                heap.DeleteMax(top);
+
+                // stale entry - vertex was already reached with shorter distance
+                if (top.first != lazyDist[top.second]) continue;
+
+                for (size_t e = top.second * degree; e < (top.second + 1) * degree; ++e) {
+                    if (const int64_t nDist = top.first + weights[e]; nDist < lazyDist[targets[e]]) {
+                        lazyDist[targets[e]] = nDist;
+                        heap.Insert(std::make_pair(nDist, targets[e]));
+                        ++lazyPushes;
+                    }
+                }
+            }
+        }
+        const double lazyTime = elapsed(start);
+
+        std::vector<int64_t> dist(vertexCount, unreachable);
+        std::vector<HeapHandle> handles(vertexCount);
+        size_t decreases = 0;
+
+        start = std::chrono::steady_clock::now();
+        {
+            indexedHeap heap{};
+            dist[0] = 0;
+            handles[0] = heap.Insert(std::make_pair(int64_t{0}, uint32_t{0}));
+
+            while (!heap.IsEmpty()) {
+                std::pair<int64_t, uint32_t> top;
+                heap.DeleteMax(top);
+
+                for (size_t e = top.second * degree; e < (top.second + 1) * degree; ++e) {
+                    const uint32_t target = targets[e];
+
+                    if (const int64_t nDist = top.first + weights[e]; nDist < dist[target]) {
+                        // vertex still waiting inside the heap is moved, not inserted again
+                        if (dist[target] != unreachable) {
+                            heap.DecreaseKey(handles[target], nDist);
+                            ++decreases;
+                        }
+                        else handles[target] = heap.Insert(std::make_pair(nDist, target));
+
+                        dist[target] = nDist;
+                    }
+                }
+            }
+        }
+        const double indexedTime = elapsed(start);
+
+        std::cout << "Vertices: " << vertexCount << ", edges: " << targets.size()
+                  << "\nLazy deletion: " << lazyTime << " ms, " << lazyPushes << " heap insertions"
+                  << "\nIndexed heap: " << indexedTime << " ms, " << decreases << " DecreaseKey calls"
+                  << "\nDistances " << (dist == lazyDist ? "equal" : "DIFFERENT") << "\n\n";
+    }
+}
+
 template<template<typename, typename , typename> class MergingHeapT>
 void MergingHeapTest() {
    auto stringToPairs = [](const std::string& str) {
@@ -0,0 +1,167 @@
+//
+// Created by Jlisowskyy on 10/17/26.
+//
+
+#ifndef PARALLELHELPERS_H
+#define PARALLELHELPERS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline size_t getDefaultThreadCount() {
+    const size_t hwThreads = std::thread::hardware_concurrency();
+    return hwThreads == 0 ? 1 : hwThreads;
+}
+
+// Executes func(taskIndex) for every task in range [0, taskCount). Tasks are taken by workers from shared counter,
+// so unevenly sized tasks are balanced automatically. Calling thread also works as one of the workers.
+template<class FuncT>
+void parallelForEachTask(const size_t taskCount, const size_t threadCount, FuncT&& func) {
+    std::atomic<size_t> nextTask{0};
+
+    auto worker = [&] {
+        for (size_t task = nextTask++; task < taskCount; task = nextTask++)
+            func(task);
+    };
+
+    const size_t workers = std::min(std::max<size_t>(threadCount, 1), std::max<size_t>(taskCount, 1));
+    std::vector<std::thread> threads{};
+    threads.reserve(workers - 1);
+
+    for (size_t i = 1; i < workers; ++i)
+        threads.emplace_back(worker);
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+class ThreadPool {
+    /*                  Description
+     *  Set of persistent workers executing task ranges in the same manner as parallelForEachTask,
+     *  but without spawning threads on every call. Useful for operators running many short parallel phases.
+     *
+     *  Calling thread participates in the work and runTasks returns after all tasks are finished.
+     *  Note: runTasks is not reentrant - it cannot be called from inside of the task or from many threads at once.
+     */
+
+    // ------------------------------
+    // Class creation
+    // ------------------------------
+public:
+
+    // threadCount includes the calling thread
+    explicit ThreadPool(const size_t threadCount = getDefaultThreadCount()) {
+        const size_t workers = std::max<size_t>(threadCount, 1) - 1;
+        _workers.reserve(workers);
+
+        for (size_t i = 0; i < workers; ++i)
+            _workers.emplace_back([this] { _workerLoop(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _workCv.notify_all();
+
+        for (auto& worker : _workers)
+            worker.join();
+    }
+
+    // ------------------------------
+    // Class interaction
+    // ------------------------------
+
+    template<class FuncT>
+    void runTasks(const size_t taskCount, FuncT&& func) {
+        if (taskCount == 0) return;
+
+        // no need to wake up anyone for single task
+        if (_workers.empty() || taskCount == 1) {
+            for (size_t task = 0; task < taskCount; ++task)
+                func(task);
+            return;
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            _job = std::ref(func);
+            _taskCount = taskCount;
+            _nextTask = 0;
+            _activeWorkers = _workers.size();
+            ++_generation;
+        }
+        _workCv.notify_all();
+
+        _processTasks(func);
+
+        std::unique_lock lock(_mutex);
+        _doneCv.wait(lock, [this] { return _activeWorkers == 0; });
+        _job = nullptr;
+    }
+
+    [[nodiscard]] size_t getThreadCount() const {
+        return _workers.size() + 1;
+    }
+
+    // ------------------------------
+    // Private methods
+    // ------------------------------
+private:
+
+    template<class FuncT>
+    void _processTasks(FuncT& func) {
+        for (size_t task = _nextTask++; task < _taskCount; task = _nextTask++)
+            func(task);
+    }
+
+    void _workerLoop() {
+        size_t seenGeneration{};
+
+        while (true) {
+            std::function<void(size_t)> job;
+            {
+                std::unique_lock lock(_mutex);
+                _workCv.wait(lock, [&] { return _stop || _generation != seenGeneration; });
+
+                if (_stop) return;
+                seenGeneration = _generation;
+                job = _job;
+            }
+
+            _processTasks(job);
+
+            std::lock_guard lock(_mutex);
+            if (--_activeWorkers == 0) _doneCv.notify_one();
+        }
+    }
+
+    // ------------------------------
+    // Class fields
+    // ------------------------------
+
+    std::vector<std::thread> _workers{};
+
+    std::mutex _mutex{};
+    std::condition_variable _workCv{};
+    std::condition_variable _doneCv{};
+
+    std::function<void(size_t)> _job{};
+    size_t _taskCount{};
+    std::atomic<size_t> _nextTask{};
+    size_t _activeWorkers{};
+    size_t _generation{};
+    bool _stop{};
+};
+
+#endif //PARALLELHELPERS_H
@@ -6,6 +6,7 @@
 #define STRUCTURETESTERS_H
 
 #include <chrono>
+#include <cmath>
 #include <random>
 #include <iostream>
 #include <vector>
@@ -71,12 +72,17 @@ void BinaryTreeTester(const bool interactiveMode = false) {
     }
 }
 
-template<class hashmap, bool printBuckets = false>
-void performHashTest(const size_t attemptCount, const std::vector<size_t>& elems) {
+// Note: when presize is set, map is constructed with initSize passed to its constructor
+template<class hashmap, bool printBuckets = false, bool reserve = false, bool presize = false>
+void performHashTest(const size_t attemptCount, const std::vector<size_t>& elems, [[maybe_unused]] const size_t initSize = 0) {
     double sum{};
 
     for (size_t i = 0; i < attemptCount; ++i) {
-        hashmap map{};
+        hashmap map = [&] {
+            if constexpr (presize) return hashmap(initSize);
+            else return hashmap{};
+        }();
+        if constexpr (reserve) map.reserve(elems.size());
 
         auto t1 = std::chrono::steady_clock::now();
         for (const auto num : elems) map.insert(std::make_pair(num, num));
@@ -88,7 +94,8 @@ void performHashTest(const size_t attemptCount, const std::vector<size_t>& elems
         std::cout << std::format("Attempt number {}: {}ms\n", i + 1, time);
 
         if constexpr (printBuckets) {
-            std::cout << std::format("Bucket ration in this run: {}\n\n", map.load_factor());
+            std::cout << std::format("Bucket ration in this run: {}\n", map.load_factor());
+            std::cout << std::format("Rehashes performed in this run: {}\n\n", map.getRehashCount());
         }
     }
 
@@ -96,13 +103,14 @@ void performHashTest(const size_t attemptCount, const std::vector<size_t>& elems
     std::cout << std::format("Average hashrate: {} insertsPerMs\n", 5 * elems.size() / sum);
 }
 
-template<class hashmap, bool check = false, bool get = false>
+template<class hashmap, bool check = false, bool get = false, bool optimize = false>
 void performAccessTest(const size_t attemptCount, const std::vector<size_t>& indexes, const std::vector<size_t>& elems) {
     double sum{};
 
     for (size_t i = 0; i < attemptCount; ++i) {
         hashmap map{};
         for (const auto elem : elems) map.insert(std::make_pair(elem, elem));
+        if constexpr (optimize) map.optimize();
 
         auto t1 = std::chrono::steady_clock::now();
 
@@ -238,4 +246,47 @@ void PerformInteractiveTest() {
     }while(num != 0);
 }
 
+class ZipfianGenerator {
+    /*                  Description
+     *  Generates values from range [0, n) with Zipfian distribution - value i is drawn with probability
+     *  proportional to 1 / (i+1)^theta, so few first values dominate the trace. Uses method of Gray et al.
+     *  (also used by YCSB), sampling costs O(1) after O(n) initialization.
+     *
+     *  IMPORTANT: theta has to lie in range (0, 1)
+     */
+
+public:
+    ZipfianGenerator(const size_t n, const double theta):
+        _n(n), _theta(theta), _alpha(1.0 / (1.0 - theta)), _zetan(_zeta(n, theta))
+    {
+        _eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - _zeta(2, theta) / _zetan);
+        _secondBarrier = 1.0 + std::pow(0.5, theta);
+    }
+
+    template<class EngineT>
+    size_t operator()(EngineT& eng) {
+        const double u = _dist(eng);
+        const double uz = u * _zetan;
+
+        if (uz < 1.0) return 0;
+        if (uz < _secondBarrier) return 1;
+        return std::min(_n - 1, static_cast<size_t>(_n * std::pow(_eta * u - _eta + 1.0, _alpha)));
+    }
+
+private:
+    static double _zeta(const size_t n, const double theta) {
+        double sum{};
+        for (size_t i = 1; i <= n; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    size_t _n;
+    double _theta;
+    double _alpha;
+    double _zetan;
+    double _eta{};
+    double _secondBarrier{};
+    std::uniform_real_distribution<double> _dist{0.0, 1.0};
+};
+
 #endif //STRUCTURETESTERS_H
@@ -7,11 +7,29 @@
 #include <chrono>
 #include <unordered_map>
 #include <map>
+#include <filesystem>
+#include <list>
+
+#include <malloc.h>
 
 #include "../include/HashMaps/HashingMain.h"
 #include "../include/HashMaps/plainHashMap.h"
 #include "../include/structureTesters.h"
 #include "../include/HashMaps/chainHashingMap.h"
+#include "../include/HashMaps/mappedChainMap.h"
+#include "../include/HashMaps/staticPerfectHashMap.h"
+#include "../include/HashMaps/constexprPerfectMap.h"
+#include "../include/HashMaps/hashJoin.h"
+#include "../include/HashMaps/hashGroupBy.h"
+#include "../include/HashMaps/clockCache.h"
+#include "../include/HashMaps/chainHashingSet.h"
+#include "../include/HashMaps/cowChainHashingMap.h"
+#include "../include/HashMaps/valueLogMap.h"
+#include "../include/HashMaps/compactDict.h"
+#include "../include/HashMaps/extendibleFileMap.h"
+#include "../include/HashMaps/stringInternPool.h"
+#include "../include/HashMaps/hyperLogLog.h"
+#include "../include/HashMaps/spaceSaving.h"
 
 void PlainMapTest() {
     static constexpr size_t keys[] = {
@@ -70,6 +88,19 @@ using simpleMap = _chainHashingMapT<size_t, size_t>;
 using fastListMap = _chainHashingMapT<size_t, size_t, std::equal_to<>, Fast2PowHashFunction<size_t>,
         LinkedListBucketT<size_t, size_t, std::equal_to<>>>;
 
+using hybridMap = _chainHashingMapT<size_t, size_t, std::equal_to<>, Fast2PowHashFunction<size_t>,
+        HybridHashBucketT<size_t, size_t, std::equal_to<>, Fast2PowHashFunction<size_t>>>;
+
+using cowMap = _cowChainHashingMapT<size_t, size_t>;
+
+inline size_t stringBytesHash(const std::string& str) {
+    return fnv1aHash(str);
+}
+
+using stringHash = BaseHashFunction<std::string, true, stringBytesHash>;
+using stringMap = _chainHashingMapT<std::string, size_t, std::equal_to<>, stringHash,
+        PlainHashBucketT<std::string, size_t, std::equal_to<>, stringHash>>;
+
 void HashRateTest(const bool interactive) {
     static constexpr auto elementCountDef = static_cast<size_t>(1e+5);
     static constexpr auto accessCountDef = static_cast<size_t>(1e+8);
@@ -133,6 +164,30 @@ void HashRateTest(const bool interactive) {
     std::cout << "-------------------------------------------------------\n";
     std::cout << "ChainMap with hash buckets test:\n";
     performHashTest<_chainHashingMapT<size_t, size_t>>(tryPerMap, elems);
+
+    std::cout << "-------------------------------------------------------\n";
+    std::cout << "ChainMap with hybrid buckets test:\n";
+    performHashTest<hybridMap>(tryPerMap, elems);
+
+    std::cout << "-------------------------------------------------------\n";
+    std::cout << "Unordered map with reserved size test:\n";
+    performHashTest<std::unordered_map<size_t, size_t>, false, true>(tryPerMap, elems);
+
+    std::cout << "-------------------------------------------------------\n";
+    std::cout << "ChainMap with hash buckets and reserved size test:\n";
+    performHashTest<_chainHashingMapT<size_t, size_t>, true, true>(tryPerMap, elems);
+
+    // in real pipelines distinct count is not known upfront - it is estimated with single pass of the sketch
+    auto t1 = std::chrono::steady_clock::now();
+    _hyperLogLogT<size_t> sketch{};
+    for (const auto e : elems) sketch.add(e);
+    const auto estimate = static_cast<size_t>(sketch.estimate() / _chainHashingMapT<size_t, size_t>::DefaultRehashPolicy);
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "-------------------------------------------------------\n";
+    std::cout << std::format("ChainMap with hash buckets presized with HyperLogLog estimate test (estimate: {}, took: {}ms):\n",
+        estimate, (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6);
+    performHashTest<_chainHashingMapT<size_t, size_t>, true, false, true>(tryPerMap, elems, estimate);
     std::cout << "-------------------------------------------------------\n";
 
     // ------------------------------
@@ -152,5 +207,1148 @@ void HashRateTest(const bool interactive) {
     std::cout << "-------------------------------------------------------\n";
     std::cout << "ChainMap with hash buckets test:\n";
     performAccessTest<boostedMap, true, true>(tryPerMap, accessIndexes, elems);
+
+    std::cout << "-------------------------------------------------------\n";
+    std::cout << "ChainMap with hash buckets after optimize() test:\n";
+    performAccessTest<boostedMap, true, true, true>(tryPerMap, accessIndexes, elems);
+
+    std::cout << "-------------------------------------------------------\n";
+    std::cout << "ChainMap with hybrid buckets test:\n";
+    performAccessTest<hybridMap, true>(tryPerMap, accessIndexes, elems);
     std::cout << "-------------------------------------------------------\n";
 }
+
+void SnapshotLoadTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+7);
+    static constexpr auto accessCountDef = static_cast<size_t>(1e+7);
+    static constexpr size_t elementStep = 5;
+    static constexpr size_t initElem  = 1;
+
+    size_t elementCount{};
+    size_t accessCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the snapshot loading test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many elements will be stored inside the map:\n";
+        std::cin >> elementCount;
+        std::cout << "  2) Access count - defines how many lookups will be performed on the mapped snapshot:\n";
+        std::cin >> accessCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+    accessCount = accessCount > 0 ? accessCount : accessCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> elems{};
+
+    size_t elem = initElem;
+    for (size_t i = 0; i < elementCount; ++i) {
+        elems.push_back(elem);
+        elem += 1 + eng() % elementStep;
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chainMapSnapshot.bin").string();
+
+    // ------------------------------
+    // Rebuilding by insertion
+    // ------------------------------
+
+    auto t1 = std::chrono::steady_clock::now();
+    simpleMap map{};
+    for (const auto e : elems) map.insert(e, e);
+    auto t2 = std::chrono::steady_clock::now();
+    const double buildTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    t1 = std::chrono::steady_clock::now();
+    map.saveSnapshot(path);
+    t2 = std::chrono::steady_clock::now();
+    const double saveTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    // ------------------------------
+    // Loading by mapping
+    // ------------------------------
+
+    t1 = std::chrono::steady_clock::now();
+    const MappedChainMap<size_t, size_t> mapped(path);
+    t2 = std::chrono::steady_clock::now();
+    const double mapTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    size_t checkSum{};
+    size_t misses{};
+    t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < accessCount; ++i) {
+        const size_t key = elems[eng() % elementCount];
+
+        if (const size_t* item = mapped.find(key); item) checkSum += *item;
+        else ++misses;
+    }
+    t2 = std::chrono::steady_clock::now();
+    const double accessTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    std::cout << std::format("Map with {} elements built by insertion in: {}ms\n", elementCount, buildTime)
+        << std::format("Snapshot saved in: {}ms\n", saveTime)
+        << std::format("Snapshot mapped in: {}ms\n", mapTime)
+        << std::format("{} lookups on mapped snapshot (including page faults) took: {}ms, accessesPerMs: {}\n",
+            accessCount, accessTime, accessCount / accessTime)
+        << std::format("Missed keys: {}, checksum: {}\n", misses, checkSum);
+
+    std::filesystem::remove(path);
+}
+
+void StaticPerfectMapTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+6);
+    static constexpr auto accessCountDef = static_cast<size_t>(1e+7);
+    static constexpr size_t elementStep = 5;
+    static constexpr size_t initElem  = 1;
+
+    size_t elementCount{};
+    size_t accessCount{};
+    size_t threadCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the static perfect hash map test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many elements will be stored inside the maps:\n";
+        std::cin >> elementCount;
+        std::cout << "  2) Access count - defines how many lookups will be performed on both maps:\n";
+        std::cin >> accessCount;
+        std::cout << "  3) Thread count - defines how many threads will build the perfect hash function:\n";
+        std::cin >> threadCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+    accessCount = accessCount > 0 ? accessCount : accessCountDef;
+    threadCount = threadCount > 0 ? threadCount : getDefaultThreadCount();
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> elems{};
+    std::vector<size_t> accessIndexes{};
+
+    size_t elem = initElem;
+    for (size_t i = 0; i < elementCount; ++i) {
+        elems.push_back(elem);
+        elem += 1 + eng() % elementStep;
+    }
+
+    for (size_t i = 0; i < accessCount; ++i)
+        accessIndexes.push_back(eng() % elementCount);
+
+    auto t1 = std::chrono::steady_clock::now();
+    const _staticPerfectHashMapT<size_t, size_t> perfectMap(elems, elems, threadCount);
+    auto t2 = std::chrono::steady_clock::now();
+    const double buildTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    t1 = std::chrono::steady_clock::now();
+    simpleMap chainMap{};
+    for (const auto e : elems) chainMap.insert(e, e);
+    t2 = std::chrono::steady_clock::now();
+    const double chainBuildTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    size_t checkSum{};
+    t1 = std::chrono::steady_clock::now();
+    for (const auto ind : accessIndexes) checkSum += perfectMap.get(elems[ind]);
+    t2 = std::chrono::steady_clock::now();
+    const double accessTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    t1 = std::chrono::steady_clock::now();
+    for (const auto ind : accessIndexes) checkSum -= chainMap.get(elems[ind]);
+    t2 = std::chrono::steady_clock::now();
+    const double chainAccessTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    std::cout << std::format("Perfect hash map with {} elements built with {} threads in: {}ms\n", elementCount, threadCount, buildTime)
+        << std::format("Perfect hash function memory: {} bits per key\n", perfectMap.getHashBitsPerKey())
+        << std::format("Chain map built by insertion in: {}ms\n", chainBuildTime)
+        << std::format("Perfect hash map: {} accessesPerMs\n", accessCount / accessTime)
+        << std::format("Chain map: {} accessesPerMs\n", accessCount / chainAccessTime)
+        << std::format("Checksum (should be 0): {}\n", checkSum);
+}
+
+static constexpr std::pair<std::string_view, int> mnemonics[] = {
+    {"nop", 0x00}, {"mov", 0x01}, {"add", 0x02}, {"sub", 0x03}, {"mul", 0x04}, {"div", 0x05},
+    {"and", 0x06}, {"or", 0x07}, {"xor", 0x08}, {"not", 0x09}, {"shl", 0x0A}, {"shr", 0x0B},
+    {"cmp", 0x0C}, {"jmp", 0x0D}, {"je", 0x0E}, {"jne", 0x0F}, {"call", 0x10}, {"ret", 0x11},
+    {"push", 0x12}, {"pop", 0x13},
+};
+
+static constexpr _constexprPerfectMapT<std::string_view, int, std::size(mnemonics), ceilPow2(std::size(mnemonics)) * 2,
+    [](const std::string_view& str) { return fnv1aHash(str); }> mnemonicTable(mnemonics);
+
+static_assert(mnemonicTable.get("call") == 0x10 && mnemonicTable.search("pop") && !mnemonicTable.search("halt"),
+    "Compile-time perfect map has to answer lookups during compilation");
+
+void ConstexprPerfectMapTest() {
+    std::cout << std::format("Mnemonic table with {} keys uses {} slots, all parameters were found during compilation\n",
+        mnemonicTable.size(), mnemonicTable.getTableSize());
+
+    std::cout << "Write mnemonics to get their opcodes, \"exit\" ends the presentation:\n";
+
+    std::string mnemonic{};
+    while (std::cin >> mnemonic && mnemonic != "exit") {
+        if (const int* opcode = mnemonicTable.find(mnemonic); opcode)
+            std::cout << std::format("{} -> {}\n", mnemonic, *opcode);
+        else
+            std::cout << std::format("{} is not a known mnemonic\n", mnemonic);
+    }
+}
+
+void HashJoinTest(const bool interactive) {
+    static constexpr size_t tupleCounts[] = {
+        static_cast<size_t>(1e+6), static_cast<size_t>(1e+7), static_cast<size_t>(1e+8)
+    };
+    static constexpr auto maxTupleCountDef = static_cast<size_t>(1e+7);
+
+    size_t maxTupleCount{};
+    size_t threadCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the hash join test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Max tuple count - joins of 1M, 10M and 100M tuples per side are run up to this count:\n";
+        std::cin >> maxTupleCount;
+        std::cout << "  2) Thread count - defines how many threads will execute the join:\n";
+        std::cin >> threadCount;
+    }
+
+    maxTupleCount = maxTupleCount > 0 ? maxTupleCount : maxTupleCountDef;
+    threadCount = threadCount > 0 ? threadCount : getDefaultThreadCount();
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    ThreadPool pool(threadCount);
+
+    for (const size_t tupleCount : tupleCounts) {
+        if (tupleCount > maxTupleCount) break;
+
+        // keys drawn from [0, tupleCount) - on average every probe tuple matches single build tuple
+        std::vector<size_t> build(tupleCount);
+        std::vector<size_t> probe(tupleCount);
+        for (auto& key : build) key = eng() % tupleCount;
+        for (auto& key : probe) key = eng() % tupleCount;
+
+        std::cout << std::format("Join of {} x {} tuples with {} threads:\n", tupleCount, tupleCount, threadCount);
+
+        for (const auto mode : { HashJoinMode::NoPartitioning, HashJoinMode::RadixPartitioning }) {
+            RadixHashJoin<size_t> join(pool, mode);
+
+            const auto t1 = std::chrono::steady_clock::now();
+            const auto matches = join.join(build, probe);
+            const auto t2 = std::chrono::steady_clock::now();
+            const double joinTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+            size_t checkSum{};
+            for (const auto& [b, p] : matches) checkSum += build[b] == probe[p];
+
+            std::cout << std::format("    {}: {}ms, partitions: {}, matches: {}, correct matches: {}, tuplesPerMs: {}\n",
+                mode == HashJoinMode::NoPartitioning ? "No partitioning   " : "Radix partitioning",
+                joinTime, join.getPartitionCount(), matches.size(), checkSum, 2 * tupleCount / joinTime);
+        }
+    }
+}
+
+void GroupByTest(const bool interactive) {
+    static constexpr auto rowCountDef = static_cast<size_t>(1e+7);
+    static constexpr auto groupCountDef = static_cast<size_t>(1e+5);
+    static constexpr int64_t maxValue = 1000;
+
+    size_t rowCount{};
+    size_t groupCount{};
+    size_t threadCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the group-by test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Row count - defines how many rows will be aggregated:\n";
+        std::cin >> rowCount;
+        std::cout << "  2) Group count - defines how many distinct keys rows contain:\n";
+        std::cin >> groupCount;
+        std::cout << "  3) Thread count - defines how many threads will be used by parallel aggregation:\n";
+        std::cin >> threadCount;
+    }
+
+    rowCount = rowCount > 0 ? rowCount : rowCountDef;
+    groupCount = groupCount > 0 ? groupCount : groupCountDef;
+    threadCount = threadCount > 0 ? threadCount : getDefaultThreadCount();
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(rowCount);
+    std::vector<std::vector<int64_t>> values(1, std::vector<int64_t>(rowCount));
+
+    for (size_t i = 0; i < rowCount; ++i) {
+        keys[i] = eng() % groupCount;
+        values[0][i] = static_cast<int64_t>(eng() % (2 * maxValue)) - maxValue;
+    }
+
+    auto measure = [&](const char* name, auto&& func) {
+        const auto t1 = std::chrono::steady_clock::now();
+        const size_t groups = func();
+        const auto t2 = std::chrono::steady_clock::now();
+        const double time = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+        std::cout << std::format("{}: {}ms, groups: {}, rowsPerMs: {}\n", name, time, groups, rowCount / time);
+    };
+
+    std::cout << std::format("Aggregating {} rows into ~{} groups:\n", rowCount, groupCount);
+
+    measure("Counting with unordered_map operator[]", [&] {
+        std::unordered_map<size_t, size_t> map{};
+        for (const auto key : keys) ++map[key];
+        return map.size();
+    });
+
+    measure("Counting with chain map operator[]     ", [&] {
+        simpleMap map{};
+        for (const auto key : keys) ++map[key];
+        return map.size();
+    });
+
+    measure("Counting with batched group-by         ", [&] {
+        HashGroupBy<size_t> groupBy{};
+        groupBy.consume(keys, {});
+        return groupBy.getGroupCount();
+    });
+
+    measure("Count/sum/min/max with batched group-by", [&] {
+        HashGroupBy<size_t> groupBy(1);
+        groupBy.consume(keys, values);
+        return groupBy.getGroupCount();
+    });
+
+    ThreadPool pool(threadCount);
+    HashGroupBy<size_t> parallelGroupBy(1);
+    measure(std::format("Count/sum/min/max with {} threads      ", threadCount).c_str(), [&] {
+        parallelGroupBy.consume(keys, values, pool);
+        return parallelGroupBy.getGroupCount();
+    });
+
+    // validating parallel result against plain counting
+    std::unordered_map<size_t, size_t> counts{};
+    for (const auto key : keys) ++counts[key];
+
+    size_t mismatches{};
+    for (const auto& [key, count] : counts)
+        if (const size_t group = parallelGroupBy.findGroup(key); group == HashGroupBy<size_t>::NoGroup || parallelGroupBy.getCount(group) != count)
+            ++mismatches;
+
+    std::cout << std::format("Groups with wrong count (should be 0): {}\n", mismatches);
+}
+
+// Baseline for CacheTest - LRU built from chain map and separate recency list, which is relinked on every hit
+class ListLruCache {
+public:
+    explicit ListLruCache(const size_t capacity): _capacity(capacity) {
+        _indexes.reserve(capacity);
+    }
+
+    template<class LoaderT>
+    size_t& getOrLoad(const size_t key, LoaderT&& loader) {
+        if (auto* it = _indexes.find(key)) {
+            _recency.splice(_recency.begin(), _recency, *it);
+            return (*it)->second;
+        }
+
+        if (_recency.size() == _capacity) {
+            _indexes.remove(_recency.back().first);
+            _recency.pop_back();
+        }
+
+        _recency.emplace_front(key, loader(key));
+        _indexes.insert(key, _recency.begin());
+        return _recency.front().second;
+    }
+
+private:
+    using listT = std::list<std::pair<size_t, size_t>>;
+
+    size_t _capacity;
+    listT _recency{};
+    _chainHashingMapT<size_t, listT::iterator> _indexes{};
+};
+
+void CacheTest(const bool interactive) {
+    static constexpr auto capacityDef = static_cast<size_t>(1e+4);
+    static constexpr auto keyCountDef = static_cast<size_t>(1e+6);
+    static constexpr auto accessCountDef = static_cast<size_t>(1e+7);
+    static constexpr double thetaDef = 0.99;
+    static constexpr size_t loadCost = 64;
+
+    size_t capacity{};
+    size_t keyCount{};
+    size_t accessCount{};
+    double theta{};
+
+    if (interactive) {
+        std::cout << "Welcome to the bounded cache test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Capacity - defines how many items fit into the cache:\n";
+        std::cin >> capacity;
+        std::cout << "  2) Key count - defines how many distinct keys backing store contains:\n";
+        std::cin >> keyCount;
+        std::cout << "  3) Access count - defines length of the Zipfian trace:\n";
+        std::cin >> accessCount;
+        std::cout << "  4) Theta - skew of the Zipfian distribution from range (0, 1):\n";
+        std::cin >> theta;
+    }
+
+    capacity = capacity > 0 ? capacity : capacityDef;
+    keyCount = keyCount > 0 ? keyCount : keyCountDef;
+    accessCount = accessCount > 0 ? accessCount : accessCountDef;
+    theta = theta > 0 && theta < 1 ? theta : thetaDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    ZipfianGenerator zipf(keyCount, theta);
+
+    // ranks are scattered over key space, so hot keys are not neighbours
+    std::vector<size_t> trace(accessCount);
+    for (auto& key : trace) key = zipf(eng) * 2654435761 + 1;
+
+    // simulates slow backing store
+    size_t loads{};
+    auto loader = [&](const size_t key) {
+        ++loads;
+
+        size_t item = key;
+        for (size_t i = 0; i < loadCost; ++i) item = item * 6364136223846793005 + 1442695040888963407;
+        return item;
+    };
+
+    auto measure = [&](const char* name, auto& cache) {
+        loads = 0;
+        size_t checkSum{};
+
+        const auto t1 = std::chrono::steady_clock::now();
+        for (const auto key : trace) checkSum += cache.getOrLoad(key, loader);
+        const auto t2 = std::chrono::steady_clock::now();
+        const double time = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+        std::cout << std::format("{}: {}ms, hit ratio: {}, opsPerMs: {}, checksum: {}\n",
+            name, time, 1.0 - static_cast<double>(loads) / accessCount, accessCount / time, checkSum);
+    };
+
+    std::cout << std::format("Zipfian trace of {} accesses over {} keys with theta {}, cache capacity: {}\n",
+        accessCount, keyCount, theta, capacity);
+
+    _clockCacheT<size_t, size_t> clockCache(capacity);
+    measure("CLOCK cache          ", clockCache);
+    std::cout << std::format("CLOCK cache reported hit ratio: {}\n", clockCache.getHitRatio());
+
+    ListLruCache lruCache(capacity);
+    measure("Map + list LRU cache ", lruCache);
+
+    // throwing loader should leave cache untouched, so later evictions stay consistent with the index
+    _clockCacheT<size_t, size_t> tinyCache(1);
+    size_t failures{};
+    auto plainLoader = [](const size_t key) { return key; };
+    auto throwingLoader = [](const size_t) -> size_t { throw std::runtime_error("load failed"); };
+
+    (void)tinyCache.getOrLoad(3, plainLoader);
+    try { (void)tinyCache.getOrLoad(5, throwingLoader); }
+    catch (const std::runtime_error&) {}
+
+    if (tinyCache.size() != 1 || !tinyCache.peek(3) || tinyCache.peek(5)) ++failures;
+    if (tinyCache.getOrLoad(7, plainLoader) != 7 || tinyCache.peek(3) || !tinyCache.peek(7)) ++failures;
+    if (tinyCache.getOrLoad(3, plainLoader) != 3 || tinyCache.peek(7)) ++failures;
+
+    std::cout << std::format("Throwing loader checks failed (should be 0): {}\n", failures);
+}
+
+void SetMemoryTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+6);
+    static constexpr size_t elementStep = 5;
+    static constexpr size_t initElem  = 1;
+
+    size_t elementCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the key-only set memory test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many keys will be inserted:\n";
+        std::cin >> elementCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> elems{};
+
+    size_t elem = initElem;
+    for (size_t i = 0; i < elementCount; ++i) {
+        elems.push_back(elem);
+        elem += 1 + eng() % elementStep;
+    }
+
+    // measures heap bytes held by the structure after inserting all keys
+    auto measure = [&](const char* name, auto structure, auto&& insertFunc) {
+        const size_t before = mallinfo2().uordblks;
+
+        const auto t1 = std::chrono::steady_clock::now();
+        for (const auto e : elems) insertFunc(structure, e);
+        const auto t2 = std::chrono::steady_clock::now();
+        const double time = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+        const size_t used = mallinfo2().uordblks - before;
+        std::cout << std::format("{}: {} bytes per key, built in {}ms, size: {}\n",
+            name, static_cast<double>(used) / elementCount, time, structure.size());
+    };
+
+    std::cout << std::format("Inserting {} distinct keys:\n", elementCount);
+
+    measure("ChainMap<size_t, size_t> with hash buckets", simpleMap{},
+        [](auto& map, const size_t key) { map.insert(key, key); });
+    measure("ChainSet<size_t> with hash buckets        ", _chainHashingSetT<size_t>{},
+        [](auto& set, const size_t key) { set.insert(key); });
+    measure("ChainMap<size_t, size_t> with list buckets", fastListMap{},
+        [](auto& map, const size_t key) { map.insert(key, key); });
+    measure("ChainMap<size_t, size_t> with hybrid buckets", hybridMap{},
+        [](auto& map, const size_t key) { map.insert(key, key); });
+    measure("ChainSet<size_t> with list buckets        ",
+        _chainHashingSetT<size_t, std::equal_to<>, Fast2PowHashFunction<size_t>, LinkedListBucketT<size_t, EmptyItem, std::equal_to<>>>{},
+        [](auto& set, const size_t key) { set.insert(key); });
+}
+
+void SpaceSavingTest(const bool interactive) {
+    static constexpr size_t capacityDef = 1000;
+    static constexpr size_t topKDef = 100;
+    static constexpr auto keyCountDef = static_cast<size_t>(1e+6);
+    static constexpr auto streamLengthDef = static_cast<size_t>(1e+7);
+    static constexpr double thetaDef = 0.99;
+
+    size_t capacity{};
+    size_t topK{};
+    size_t keyCount{};
+    size_t streamLength{};
+    double theta{};
+
+    if (interactive) {
+        std::cout << "Welcome to the Space-Saving heavy hitters test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Capacity - defines how many counters tracker holds:\n";
+        std::cin >> capacity;
+        std::cout << "  2) K - defines how many top keys are compared against exact result:\n";
+        std::cin >> topK;
+        std::cout << "  3) Key count - defines how many distinct keys stream can contain:\n";
+        std::cin >> keyCount;
+        std::cout << "  4) Stream length - defines how many events are processed:\n";
+        std::cin >> streamLength;
+        std::cout << "  5) Theta - skew of the Zipfian distribution from range (0, 1):\n";
+        std::cin >> theta;
+    }
+
+    capacity = capacity > 0 ? capacity : capacityDef;
+    topK = topK > 0 ? std::min(topK, capacity) : std::min(topKDef, capacity);
+    keyCount = keyCount > 0 ? keyCount : keyCountDef;
+    streamLength = streamLength > 0 ? streamLength : streamLengthDef;
+    theta = theta > 0 && theta < 1 ? theta : thetaDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    ZipfianGenerator zipf(keyCount, theta);
+
+    std::vector<size_t> stream(streamLength);
+    for (auto& key : stream) key = zipf(eng) * 2654435761 + 1;
+
+    std::cout << std::format("Zipfian stream of {} events over {} keys with theta {}, {} counters:\n",
+        streamLength, keyCount, theta, capacity);
+
+    auto t1 = std::chrono::steady_clock::now();
+    _spaceSavingT<size_t> tracker(capacity);
+    for (const auto key : stream) tracker.add(key);
+    auto t2 = std::chrono::steady_clock::now();
+    const double trackTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    t1 = std::chrono::steady_clock::now();
+    std::unordered_map<size_t, size_t> exact{};
+    for (const auto key : stream) ++exact[key];
+    t2 = std::chrono::steady_clock::now();
+    const double exactTime = (t2.time_since_epoch() - t1.time_since_epoch()).count()*1e-6;
+
+    std::vector<std::pair<size_t, size_t>> exactTop(exact.begin(), exact.end());
+    std::partial_sort(exactTop.begin(), exactTop.begin() + std::min(topK, exactTop.size()), exactTop.end(),
+        [](const auto& a, const auto& b) { return a.second > b.second; });
+    exactTop.resize(std::min(topK, exactTop.size()));
+
+    // recall of exact top-K and error of reported counts
+    size_t found{};
+    double relErrorSum{};
+    for (const auto& [key, count] : exactTop) {
+        if (tracker.isTracked(key)) ++found;
+        relErrorSum += static_cast<double>(tracker.estimate(key) - count) / count;
+    }
+
+    size_t maxError{};
+    for (const auto& hitter : tracker.getTopK(topK))
+        maxError = std::max(maxError, hitter.count - exact[hitter.key]);
+
+    std::cout << std::format("Space-Saving: {}ms, eventsPerMs: {}\n", trackTime, streamLength / trackTime)
+        << std::format("Exact unordered_map counting: {}ms, eventsPerMs: {}, distinct keys: {}\n",
+            exactTime, streamLength / exactTime, exact.size())
+        << std::format("Top-{} recall: {}, average relative overestimation: {}\n",
+            topK, static_cast<double>(found) / exactTop.size(), relErrorSum / exactTop.size())
+        << std::format("Maximal absolute error among reported top-{}: {}, guaranteed bound: {}\n",
+            topK, maxError, tracker.getMinCount());
+}
+
+void ShardPlacementTest(const bool interactive) {
+    static constexpr size_t shardCounts[] = { 10, 100, 1000, 10000 };
+    static constexpr auto keyCountDef = static_cast<size_t>(1e+6);
+    static constexpr auto rendezvousBudget = static_cast<size_t>(1e+8); // maximal key * shard evaluations per rendezvous test
+
+    size_t keyCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the shard placement test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Key count - defines how many keys are placed on shards:\n";
+        std::cin >> keyCount;
+    }
+
+    keyCount = keyCount > 0 ? keyCount : keyCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(keyCount);
+    for (auto& key : keys) key = eng();
+
+    std::vector<size_t> before(keyCount);
+    std::vector<size_t> after(keyCount);
+
+    // places keys with n and n + 1 shards, reports fraction of moved keys and time of single placement
+    auto measure = [&](const char* name, const size_t shards, const size_t count, auto&& place) {
+        const auto t1 = std::chrono::steady_clock::now();
+        place(shards, count, before.data());
+        const auto t2 = std::chrono::steady_clock::now();
+        place(shards + 1, count, after.data());
+
+        size_t moved{};
+        for (size_t i = 0; i < count; ++i) moved += before[i] != after[i];
+
+        const double nsPerKey = static_cast<double>((t2 - t1).count()) / count;
+        std::cout << std::format("    {}: moved fraction: {}, ns/key: {}\n", name, static_cast<double>(moved) / count, nsPerKey);
+    };
+
+    for (const size_t shards : shardCounts) {
+        std::cout << std::format("Growing from {} to {} shards (ideal moved fraction: {}):\n", shards, shards + 1, 1.0 / (shards + 1));
+
+        measure("Modulo           ", shards, keyCount, [&](const size_t n, const size_t count, size_t* out) {
+            for (size_t i = 0; i < count; ++i) out[i] = mixHash64(keys[i]) % n;
+        });
+
+        measure("Jump consistent  ", shards, keyCount, [&](const size_t n, const size_t count, size_t* out) {
+            const JumpConsistentHash<size_t> placement(n);
+            placement(keys.data(), count, out);
+        });
+
+        const size_t rendezvousKeys = std::min(keyCount, rendezvousBudget / shards);
+        measure("Rendezvous       ", shards, rendezvousKeys, [&](const size_t n, const size_t count, size_t* out) {
+            const WeightedRendezvousHash<size_t> placement(n);
+            placement(keys.data(), count, out);
+        });
+    }
+}
+
+void ParallelRehashTest(const bool interactive) {
+    static constexpr size_t threadCounts[] = { 1, 2, 4, 8, 16 };
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+7);
+
+    size_t elementCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the parallel rehash test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many keys are held by rehashed map:\n";
+        std::cin >> elementCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::cout << std::format("Rehashing maps holding {} keys (hardware threads: {}):\n", elementCount, getDefaultThreadCount());
+
+    // full rehash with same bucket count is forced by unreachable desired load
+    auto measure = [&](const char* name, auto map) {
+        for (size_t i = 0; i < elementCount; ++i) map.insert(eng(), i);
+        std::cout << name << ":\n";
+
+        double singleThreaded{};
+        for (const size_t threads : threadCounts) {
+            map.setThreadCount(threads);
+
+            const auto t1 = std::chrono::steady_clock::now();
+            map.rehash(0.0f, 1);
+            const auto t2 = std::chrono::steady_clock::now();
+
+            const double time = (t2 - t1).count() * 1e-6;
+            if (threads == 1) singleThreaded = time;
+
+            std::cout << std::format("    {:>2} threads: {}ms, speedup: {}\n", threads, time, singleThreaded / time);
+        }
+    };
+
+    measure("ChainMap with hash buckets", simpleMap{});
+    measure("ChainMap with list buckets", fastListMap{});
+    measure("ChainMap with hybrid buckets", hybridMap{});
+}
+
+void CowSnapshotTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+6);
+    static constexpr auto writeCountDef = static_cast<size_t>(1e+4);
+    static constexpr size_t snapshotCount = 5;
+
+    size_t elementCount{};
+    size_t writeCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the copy-on-write snapshot test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many keys are held by the map:\n";
+        std::cin >> elementCount;
+
+        std::cout << "    2) Write count - defines how many updates are performed between snapshots:\n";
+        std::cin >> writeCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+    writeCount = writeCount > 0 ? writeCount : writeCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(elementCount);
+    for (auto& key : keys) key = eng();
+
+    simpleMap map{};
+    cowMap cMap{};
+    for (const auto key : keys) {
+        map.insert(key, key);
+        cMap.insert(key, key);
+    }
+
+    std::cout << std::format("Taking {} snapshots of map with {} keys, {} random updates after each one:\n",
+        snapshotCount, elementCount, writeCount);
+
+    // all snapshots are kept alive, so every one of them pins pages, which were modified after it
+    std::vector<simpleMap> copies{};
+    std::vector<cowMap> snapshots{};
+
+    for (size_t round = 0; round < snapshotCount; ++round) {
+        auto t1 = std::chrono::steady_clock::now();
+        copies.push_back(map);
+        auto t2 = std::chrono::steady_clock::now();
+        snapshots.push_back(cMap.snapshot());
+        auto t3 = std::chrono::steady_clock::now();
+
+        std::vector<size_t> updated(writeCount);
+        for (auto& key : updated) key = keys[eng() % elementCount];
+        for (const auto key : updated) ++map[key];
+
+        cMap.resetStats();
+        const size_t memBefore = mallinfo2().uordblks;
+
+        auto t4 = std::chrono::steady_clock::now();
+        for (const auto key : updated) ++cMap[key];
+        auto t5 = std::chrono::steady_clock::now();
+
+        const size_t memAfter = mallinfo2().uordblks;
+        const auto stats = cMap.getStats();
+
+        std::cout << std::format("Round {}:\n", round + 1)
+        << std::format("    Deep copy: {}ms, snapshot: {}ms\n", (t2 - t1).count() * 1e-6, (t3 - t2).count() * 1e-6)
+        << std::format("    Writes after snapshot: {}ms, copied pages: {}, copied buckets per write: {}\n",
+            (t5 - t4).count() * 1e-6, stats.copiedPages, static_cast<double>(stats.copiedBuckets) / stats.writes)
+        << std::format("    Shared pages: {} of {}, memory added by writes: {} bytes\n",
+            stats.sharedPages, stats.pageCount, memAfter - memBefore)
+        << std::format("    Page memory exclusive to map: {} bytes, shared with snapshots: {} bytes, copied: {} bytes\n",
+            stats.exclusiveBytes, stats.sharedBytes, stats.copiedBytes);
+    }
+
+    size_t mismatches{};
+    for (size_t i = 0; i < snapshotCount; ++i)
+        for (const auto key : keys)
+            mismatches += *copies[i].find(key) != *std::as_const(snapshots[i]).find(key);
+
+    std::cout << std::format("Snapshots differing from deep copies: {}\n", mismatches);
+}
+
+void ValueLogTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+6);
+    static constexpr size_t itemSize = 256;
+
+    struct bigItem {
+        size_t value;
+        char payload[itemSize - sizeof(size_t)];
+    };
+
+    size_t elementCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the value log test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many keys will be inserted:\n";
+        std::cin >> elementCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(elementCount);
+    for (auto& key : keys) key = eng();
+
+    std::vector<size_t> accessed(elementCount);
+    for (auto& key : accessed) key = keys[eng() % elementCount];
+
+    std::cout << std::format("Inserting {} keys with {}-byte items, then updating every key once:\n", elementCount, itemSize);
+
+    auto measure = [&](const char* name, auto map, auto&& update) {
+        bigItem item{};
+
+        auto t1 = std::chrono::steady_clock::now();
+        for (const auto key : keys) {
+            item.value = key;
+            map.insert(key, item);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        size_t sum{};
+        for (const auto key : accessed) sum += map.find(key)->value;
+        auto t3 = std::chrono::steady_clock::now();
+
+        for (const auto key : keys) {
+            item.value = key + 1;
+            update(map, key, item);
+        }
+        auto t4 = std::chrono::steady_clock::now();
+
+        std::cout << std::format("{}:\n    insert: {}ms ({} rehashes), random access: {}ms, update: {}ms, checksum: {}\n",
+            name, (t2 - t1).count() * 1e-6, map.getRehashCount(), (t3 - t2).count() * 1e-6, (t4 - t3).count() * 1e-6, sum);
+        return map;
+    };
+
+    measure("ChainMap with inline items", _chainHashingMapT<size_t, bigItem>{},
+        [](auto& map, const size_t key, const bigItem& item) { *map.find(key) = item; });
+
+    const auto logMap = measure("ChainMap with value log", _valueLogMapT<size_t, bigItem>{},
+        [](auto& map, const size_t key, const bigItem& item) { map.assign(key, item); });
+
+    std::cout << std::format("    value log: {} items, {} dead, {} compactions\n",
+        logMap.getLogSize(), logMap.getDeadCount(), logMap.getCompactionCount());
+}
+
+void CompactDictTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+6);
+    static constexpr size_t iterationCount = 10;
+
+    size_t elementCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the compact dict test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many keys will be inserted:\n";
+        std::cin >> elementCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(elementCount);
+    for (auto& key : keys) key = eng();
+
+    std::vector<size_t> accessed(elementCount);
+    for (auto& key : accessed) key = keys[eng() % elementCount];
+
+    std::cout << std::format("Inserting {} keys, then {} full iterations and {} random lookups:\n",
+        elementCount, iterationCount, elementCount);
+
+    auto measure = [&](const char* name, auto structure, auto&& iterate, auto&& contains) {
+        const size_t before = mallinfo2().uordblks;
+
+        auto t1 = std::chrono::steady_clock::now();
+        for (const auto key : keys) structure.insert(std::make_pair(key, key));
+        auto t2 = std::chrono::steady_clock::now();
+
+        const size_t used = mallinfo2().uordblks - before;
+
+        size_t sum{};
+        for (size_t i = 0; i < iterationCount; ++i) sum += iterate(structure);
+        auto t3 = std::chrono::steady_clock::now();
+
+        for (const auto key : accessed) sum += contains(structure, key);
+        auto t4 = std::chrono::steady_clock::now();
+
+        std::cout << std::format("{}: {} bytes per key, insert: {}ms, iteration: {}ms, lookup: {}ms, checksum: {}\n",
+            name, static_cast<double>(used) / elementCount, (t2 - t1).count() * 1e-6,
+            (t3 - t2).count() * 1e-6 / iterationCount, (t4 - t3).count() * 1e-6, sum);
+    };
+
+    auto sumItems = [](const auto& structure) {
+        size_t sum{};
+        structure.forEach([&](const size_t, const size_t item) { sum += item; });
+        return sum;
+    };
+
+    auto search = [](const auto& structure, const size_t key) { return structure.search(key); };
+
+    measure("unordered_map          ", std::unordered_map<size_t, size_t>{}, [](const auto& map) {
+        size_t sum{};
+        for (const auto& [key, item] : map) sum += item;
+        return sum;
+    }, [](const auto& map, const size_t key) { return map.contains(key); });
+    measure("ChainMap with hash buckets", simpleMap{}, sumItems, search);
+    measure("Compact dict           ", _compactDictT<size_t, size_t>{}, sumItems, search);
+
+    // insertion order has to survive removals, growth and shrink_to_fit
+    _compactDictT<size_t, size_t> dict{};
+    std::vector<size_t> expected{};
+
+    for (const auto key : keys)
+        if (dict.insert(key, key)) expected.push_back(key);
+
+    for (size_t i = 0; i < expected.size(); i += 2) dict.safeRemove(expected[i]);
+    std::erase_if(expected, [&](const size_t key) { return !dict.search(key); });
+
+    for (size_t i = 0; i < elementCount; ++i)
+        if (const size_t key = eng(); dict.insert(key, key)) expected.push_back(key);
+
+    dict.shrink_to_fit();
+
+    std::vector<size_t> order{};
+    dict.forEach([&](const size_t key, const size_t) { order.push_back(key); });
+
+    std::cout << std::format("Insertion order after removals and shrink_to_fit preserved (should be 1): {}\n",
+        order == expected && dict.size() == expected.size());
+}
+
+void ExtendibleFileMapTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(2e+6);
+    static constexpr auto accessCountDef = static_cast<size_t>(1e+6);
+    static constexpr size_t cachePagesDef = 64;
+
+    using fileMap = _extendibleFileMapT<size_t, size_t>;
+
+    size_t elementCount{};
+    size_t accessCount{};
+    size_t cachePages{};
+
+    if (interactive) {
+        std::cout << "Welcome to the file backed extendible hash map test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many elements will be stored inside the file:\n";
+        std::cin >> elementCount;
+        std::cout << "  2) Access count - defines how many random lookups will be performed:\n";
+        std::cin >> accessCount;
+        std::cout << "  3) Cache pages - defines how many 4KiB pages are kept in memory:\n";
+        std::cin >> cachePages;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+    accessCount = accessCount > 0 ? accessCount : accessCountDef;
+    cachePages = cachePages > 0 ? cachePages : cachePagesDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(elementCount);
+    for (auto& key : keys) key = eng();
+
+    const std::string path = (std::filesystem::temp_directory_path() / "extendibleFileMap.bin").string();
+    std::filesystem::remove(path);
+
+    std::cout << std::format("{} elements, page cache of {} pages ({} KiB), {} elements per page\n",
+        elementCount, cachePages, cachePages * 4, fileMap::BucketCapacity);
+
+    {
+        fileMap map(path, cachePages);
+
+        auto t1 = std::chrono::steady_clock::now();
+        for (const auto key : keys) map.insert(key, key);
+        map.flush();
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::cout << std::format("Built in: {}ms, pages read: {}, pages written: {}, splits: {}\n",
+            (t2 - t1).count() * 1e-6, map.getPageReads(), map.getPageWrites(), map.getSplitCount())
+            << std::format("File pages: {} ({} MiB), global depth: {}, average page fill: {}\n",
+                map.getPageCount(), map.getPageCount() * 4 / 1024, map.getGlobalDepth(),
+                static_cast<double>(elementCount) / (map.getSplitCount() + 1) / fileMap::BucketCapacity);
+    }
+
+    // reopened map starts with cold page cache
+    fileMap map(path, cachePages);
+
+    size_t checkSum{};
+    size_t misses{};
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < accessCount; ++i) {
+        const size_t key = keys[eng() % elementCount];
+
+        if (const size_t* item = map.find(key); item) checkSum += *item;
+        else ++misses;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    const double accessTime = (t2 - t1).count() * 1e-6;
+
+    std::cout << std::format("{} lookups took: {}ms, accessesPerMs: {}\n", accessCount, accessTime, accessCount / accessTime)
+        << std::format("Pages read per lookup: {}, cache hit ratio: {}\n",
+            static_cast<double>(map.getPageReads()) / accessCount, static_cast<double>(map.getCacheHits()) / accessCount)
+        << std::format("Missed keys: {}, checksum: {}\n", misses, checkSum);
+
+    std::filesystem::remove(path);
+}
+
+void ListCompactionTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(1e+6);
+    static constexpr size_t churnRoundsDef = 5;
+    static constexpr size_t lookupRounds = 5;
+
+    size_t elementCount{};
+    size_t churnRounds{};
+
+    if (interactive) {
+        std::cout << "Welcome to the linked list compaction test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many elements will be stored inside the map:\n";
+        std::cin >> elementCount;
+        std::cout << "  2) Churn rounds - defines how many times every element is removed and inserted again:\n";
+        std::cin >> churnRounds;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+    churnRounds = churnRounds > 0 ? churnRounds : churnRoundsDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<size_t> keys(elementCount);
+    for (auto& key : keys) key = eng();
+
+    auto measureLookups = [&](fastListMap& map) {
+        size_t sum{};
+
+        auto t1 = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < lookupRounds; ++round)
+            for (const auto key : keys) sum += *map.find(key);
+        auto t2 = std::chrono::steady_clock::now();
+
+        return std::make_pair((t2 - t1).count() * 1e-6 / lookupRounds, sum);
+    };
+
+    fastListMap map{};
+    for (const auto key : keys) map.insert(key, key);
+
+    const auto [freshTime, freshSum] = measureLookups(map);
+
+    // every round removes and reinserts all elements in random order, so nodes get scattered over the heap
+    std::vector<size_t> order = keys;
+    for (size_t round = 0; round < churnRounds; ++round) {
+        std::shuffle(order.begin(), order.end(), eng);
+        for (size_t i = 0; i < order.size(); i += 2) {
+            const size_t count = std::min<size_t>(2, order.size() - i);
+            for (size_t j = 0; j < count; ++j) map.remove(order[i + j]);
+            for (size_t j = 0; j < count; ++j) map.insert(order[i + j], order[i + j]);
+        }
+    }
+
+    const auto [churnTime, churnSum] = measureLookups(map);
+
+    auto t1 = std::chrono::steady_clock::now();
+    map.compact();
+    auto t2 = std::chrono::steady_clock::now();
+    const double compactTime = (t2 - t1).count() * 1e-6;
+
+    const auto [compactLookupTime, compactSum] = measureLookups(map);
+
+    // single churn round more, then the map is compacted incrementally, step by step
+    for (size_t i = 0; i < elementCount; ++i) {
+        map.remove(keys[i]);
+        map.insert(keys[i], keys[i]);
+    }
+
+    size_t steps{};
+    t1 = std::chrono::steady_clock::now();
+    while (!map.compactStep()) ++steps;
+    t2 = std::chrono::steady_clock::now();
+    const double stepTime = (t2 - t1).count() * 1e-6 / (steps + 1);
+
+    std::cout << std::format("{} lookups over {} elements, checksums: {} {} {}\n",
+        elementCount, elementCount, freshSum, churnSum, compactSum)
+        << std::format("Fresh build: {}ms\n", freshTime)
+        << std::format("After {} churn rounds: {}ms\n", churnRounds, churnTime)
+        << std::format("After compact(): {}ms, compaction took: {}ms\n", compactLookupTime, compactTime)
+        << std::format("compactStep() of {} buckets: {}ms on average over {} steps\n",
+            fastListMap::DefaultCompactStep, stepTime, steps + 1);
+}
+
+void StringInternTest(const bool interactive) {
+    static constexpr auto elementCountDef = static_cast<size_t>(5e+5);
+    static constexpr auto accessCountDef = static_cast<size_t>(5e+6);
+    static constexpr size_t minLength = 16;
+    static constexpr size_t maxLength = 64;
+
+    size_t elementCount{};
+    size_t accessCount{};
+
+    if (interactive) {
+        std::cout << "Welcome to the string interning test!\n"
+        << "Provide your parameteres of the test to begin:\n"
+        << "    1) Element count - defines how many distinct strings will be used as keys:\n";
+        std::cin >> elementCount;
+        std::cout << "  2) Access count - defines how many lookups will be performed:\n";
+        std::cin >> accessCount;
+    }
+
+    elementCount = elementCount > 0 ? elementCount : elementCountDef;
+    accessCount = accessCount > 0 ? accessCount : accessCountDef;
+
+    std::default_random_engine eng(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<std::string> strings(elementCount);
+    for (size_t i = 0; i < elementCount; ++i) {
+        // index prefix keeps strings distinct
+        strings[i] = std::to_string(i) + '_';
+        strings[i].resize(minLength + eng() % (maxLength - minLength + 1), 'a');
+        for (size_t j = strings[i].find('_') + 1; j < strings[i].size(); ++j) strings[i][j] = static_cast<char>('a' + eng() % 26);
+    }
+
+    std::vector<size_t> accessed(accessCount);
+    for (auto& ind : accessed) ind = eng() % elementCount;
+
+    auto elapsed = [](const auto t1) {
+        return (std::chrono::steady_clock::now() - t1).count() * 1e-6;
+    };
+
+    // ------------------------------
+    // Map keyed by strings
+    // ------------------------------
+
+    auto t1 = std::chrono::steady_clock::now();
+    stringMap strMap{};
+    for (size_t i = 0; i < elementCount; ++i) strMap.insert(strings[i], i);
+    const double strBuild = elapsed(t1);
+
+    size_t strSum{};
+    t1 = std::chrono::steady_clock::now();
+    for (const auto ind : accessed) strSum += *strMap.find(strings[ind]);
+    const double strAccess = elapsed(t1);
+
+    // ------------------------------
+    // Map keyed by interned handles
+    // ------------------------------
+
+    t1 = std::chrono::steady_clock::now();
+    StringInternPool pool{};
+    std::vector<InternedString> handles(elementCount);
+    for (size_t i = 0; i < elementCount; ++i) handles[i] = pool.intern(strings[i]);
+    const double internTime = elapsed(t1);
+
+    t1 = std::chrono::steady_clock::now();
+    InternedMapT<size_t> internMap{};
+    for (size_t i = 0; i < elementCount; ++i) internMap.insert(handles[i], i);
+    const double internBuild = elapsed(t1);
+
+    size_t handleSum{};
+    t1 = std::chrono::steady_clock::now();
+    for (const auto ind : accessed) handleSum += *internMap.find(handles[ind]);
+    const double handleAccess = elapsed(t1);
+
+    // raw strings have to be translated by the pool first
+    size_t rawSum{};
+    t1 = std::chrono::steady_clock::now();
+    for (const auto ind : accessed) rawSum += *internMap.find(*pool.find(strings[ind]));
+    const double rawAccess = elapsed(t1);
+
+    std::cout << std::format("{} strings of length [{}, {}], {} lookups, checksums: {} {} {}\n",
+        elementCount, minLength, maxLength, accessCount, strSum, handleSum, rawSum)
+        << std::format("String keyed map - build: {}ms ({} rehashes), lookups: {}ms\n",
+            strBuild, strMap.getRehashCount(), strAccess)
+        << std::format("Interning: {}ms, pool arena: {} bytes\n", internTime, pool.getArenaBytes())
+        << std::format("Handle keyed map - build: {}ms ({} rehashes), lookups by handle: {}ms, lookups by string through the pool: {}ms\n",
+            internBuild, internMap.getRehashCount(), handleAccess, rawAccess);
+}